@@ -0,0 +1,270 @@
+/*
+ * BenchDecoding.cpp
+ *
+ * End-to-end throughput and latency of BMSDecoding for the Hermitian codes
+ * over F_4, F_16 and F_64 (r = 2, 4, 8). For every error weight from 0 up
+ * to the number of correctable errors it decodes random code words (of
+ * random messages, cf. SystematicEncoder) with random error patterns of
+ * that weight, drawn with a fixed seed, and reports:
+ *   - the words decoded per second and the p50, p99 and p999 latency of
+ *     a word;
+ *   - the mean time of every phase of decoding (syndromes, BMS-algorithm,
+ *     root search, error values; cf. BMSDecoding::decode);
+ *   - the words decoded per second by \c decode called in a loop and by
+ *     \c decodeBatch for all the words at once, and the ratio of the two;
+ *   - the words whose error positions or corrected word were wrong and the
+ *     ones decodeBatch corrected otherwise than decode.
+ *
+ *     g++ -std=c++11 -O2 -DMV_POLY_TRACE_LEVEL=0 -DMV_POLY_PERF_COUNTERS=0 -o BenchDecoding BenchDecoding.cpp -lntl -lglog
+ *     ./BenchDecoding [--words N] [--seed S] [--json file]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <NTL/GF2.h>
+#include <NTL/GF2E.h>
+
+#include "NtlUtilities.hpp"
+#include "CurveArithmetic.hpp"
+#include "CodeContext.hpp"
+#include "SystematicEncoder.hpp"
+#include "bmsa-decoding.hpp"
+
+using namespace mv_poly;
+
+namespace {
+
+typedef NTL::GF2 PrimeField;
+typedef NTLPrimeFieldTtraits<PrimeField>::ExtField ExtField;
+
+typedef std::chrono::steady_clock Clock;
+
+double secondsSince(Clock::time_point const & start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+/// The \c q quantile of the sorted \c values.
+double quantile(std::vector<double> const & values, double q) {
+    if (values.empty())
+        return 0;
+    size_t const i = static_cast<size_t>(std::ceil(q * values.size()));
+    return values[std::min(values.size() - 1, i > 0 ? i - 1 : 0)];
+}
+
+/// Results of the words of one code and one error weight.
+struct Row {
+    int r;
+
+    size_t n, k;
+
+    int weight;
+
+    size_t words;
+
+    double wordsPerSecond;
+
+    double p50, p99, p999;
+
+    /// Mean time of the phases (syndromes, BMS-algorithm, roots, values).
+    double phases[4];
+
+    size_t wrongLocations, wrongWords;
+
+    /// Words per second of decode called for every word and of decodeBatch.
+    double loopWordsPerSecond, batchWordsPerSecond;
+
+    size_t wrongBatchWords;
+};
+
+std::vector<Row> rows;
+
+/**
+ * Decodes \c words random words with every error weight for the code of
+ * \c r with \c l checks over the field given by the primitive polynomial
+ * \c field.
+ */
+template<int r>
+void bench(std::string const & field, size_t l, size_t words, unsigned long seed) {
+    initExtendedField<PrimeField>(field);
+    typedef HermitianCodeParams<r, ExtField> CodeParams;
+    typedef BMSDecoding<2, CodeParams> DecoderT;
+    typedef SystematicEncoder<2, CodeParams> EncoderT;
+    typedef typename DecoderT::FieldElemsCollection Word;
+
+    typename DecoderT::Context const context(l);
+    DecoderT const decoder(context);
+    EncoderT const encoder(context);
+    size_t const n = encoder.getLength(), k = encoder.getDimension();
+    long const q = r * r;
+    ExtField const a = FieldElemTraits<ExtField>::getPrimitive();
+
+    std::mt19937_64 random(seed + r);
+    auto element = [&](bool nonzero) {
+        long const e = random() % (nonzero ? q - 1 : q);
+        return !nonzero && e == q - 1 ? ExtField() : NTL::power(a, e);
+    };
+    std::vector<size_t> positions(n);
+    for (size_t i = 0; i < n; ++i)
+        positions[i] = i;
+
+    for (int weight = 0; weight <= decoder.getCorrectable(); ++weight) {
+        std::vector<typename EncoderT::FieldElemsCollection> messages(words,
+                typename EncoderT::FieldElemsCollection(k));
+        for (size_t w = 0; w < words; ++w)
+            for (size_t f = 0; f < k; ++f)
+                messages[w][f] = element(false);
+        std::vector<Word> const codewords = encoder.encodeBatch(messages);
+
+        Row row = { r, n, k, weight, words, 0, 0, 0, 0, { 0, 0, 0, 0 }, 0, 0, 0, 0, 0 };
+        std::vector<Word> received;
+        received.reserve(words);
+        std::vector<double> latencies;
+        latencies.reserve(words);
+        double total = 0;
+        for (size_t w = 0; w < words; ++w) {
+            // the first weight positions of a partial shuffle
+            for (int e = 0; e < weight; ++e)
+                std::swap(positions[e], positions[e + random() % (n - e)]);
+            std::vector<int> errors(positions.begin(), positions.begin() + weight);
+            std::sort(errors.begin(), errors.end());
+            typename DecoderT::DecodingJob job;
+            job.received = codewords[w];
+            for (int e = 0; e < weight; ++e)
+                job.received[errors[e]] += element(true);
+            received.push_back(job.received);
+
+            double phases[4];
+            Clock::time_point start = Clock::now();
+            decoder.runSyndromeStage(job);
+            phases[0] = secondsSince(start);
+            start = Clock::now();
+            decoder.runLocatorStage(job);
+            phases[1] = secondsSince(start);
+            start = Clock::now();
+            decoder.runRootStage(job);
+            phases[2] = secondsSince(start);
+            start = Clock::now();
+            decoder.runValueStage(job);
+            phases[3] = secondsSince(start);
+
+            double latency = 0;
+            for (int p = 0; p < 4; ++p) {
+                row.phases[p] += phases[p] / words;
+                latency += phases[p];
+            }
+            latencies.push_back(latency);
+            total += latency;
+
+            std::vector<int> located(job.locations.begin(), job.locations.end());
+            std::sort(located.begin(), located.end());
+            if (located != errors)
+                ++row.wrongLocations;
+            if (job.corrected != codewords[w])
+                ++row.wrongWords;
+        }
+        std::sort(latencies.begin(), latencies.end());
+        row.wordsPerSecond = total > 0 ? words / total : 0;
+
+        std::vector<Word> loop(words);
+        Clock::time_point start = Clock::now();
+        for (size_t w = 0; w < words; ++w)
+            loop[w] = decoder.decode(received[w]);
+        double const loopSeconds = secondsSince(start);
+        start = Clock::now();
+        std::vector<Word> const batch = decoder.decodeBatch(received);
+        double const batchSeconds = secondsSince(start);
+        row.loopWordsPerSecond = loopSeconds > 0 ? words / loopSeconds : 0;
+        row.batchWordsPerSecond = batchSeconds > 0 ? words / batchSeconds : 0;
+        for (size_t w = 0; w < words; ++w)
+            if (batch[w] != loop[w])
+                ++row.wrongBatchWords;
+        row.p50 = quantile(latencies, 0.5);
+        row.p99 = quantile(latencies, 0.99);
+        row.p999 = quantile(latencies, 0.999);
+        rows.push_back(row);
+
+        std::cout << "r = " << std::setw(2) << r
+                  << "  [" << std::setw(3) << n << ", " << std::setw(3) << k << "]"
+                  << "  weight " << std::setw(2) << weight
+                  << std::fixed << std::setprecision(1)
+                  << "  " << std::setw(9) << row.wordsPerSecond << " words/s"
+                  << "  p50/p99/p999 " << row.p50 * 1e6 << "/" << row.p99 * 1e6
+                  << "/" << row.p999 * 1e6 << " us"
+                  << "  phases " << row.phases[0] * 1e6 << "/" << row.phases[1] * 1e6
+                  << "/" << row.phases[2] * 1e6 << "/" << row.phases[3] * 1e6 << " us"
+                  << "  loop/batch " << row.loopWordsPerSecond << "/"
+                  << row.batchWordsPerSecond << " words/s (x" << std::setprecision(2)
+                  << (row.loopWordsPerSecond > 0
+                          ? row.batchWordsPerSecond / row.loopWordsPerSecond : 0)
+                  << ")"
+                  << "  wrong " << row.wrongLocations << "/" << row.wrongWords
+                  << "/" << row.wrongBatchWords
+                  << std::endl;
+    }
+}
+
+void writeJson(std::ostream & os) {
+    static char const * const PHASES[] = { "syndromes", "bmsa", "roots", "values" };
+    os << "{\"rows\": [";
+    for (size_t i = 0; i < rows.size(); ++i) {
+        Row const & row = rows[i];
+        os << (i ? ",\n  " : "\n  ") << std::fixed << std::setprecision(3)
+           << "{\"r\": " << row.r << ", \"n\": " << row.n << ", \"k\": " << row.k
+           << ", \"weight\": " << row.weight << ", \"words\": " << row.words
+           << ", \"wordsPerSecond\": " << row.wordsPerSecond
+           << ", \"p50Us\": " << row.p50 * 1e6 << ", \"p99Us\": " << row.p99 * 1e6
+           << ", \"p999Us\": " << row.p999 * 1e6 << ", \"phasesUs\": {";
+        for (int p = 0; p < 4; ++p)
+            os << (p ? ", " : "") << "\"" << PHASES[p] << "\": " << row.phases[p] * 1e6;
+        os << "}, \"loopWordsPerSecond\": " << row.loopWordsPerSecond
+           << ", \"batchWordsPerSecond\": " << row.batchWordsPerSecond
+           << ", \"wrongLocations\": " << row.wrongLocations
+           << ", \"wrongWords\": " << row.wrongWords
+           << ", \"wrongBatchWords\": " << row.wrongBatchWords << "}";
+    }
+    os << "\n]}" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char * argv[]) {
+    size_t words = 200;
+    unsigned long seed = 1;
+    std::string jsonPath;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string const option = argv[i];
+        if (option == "--words")
+            words = std::atoi(argv[i + 1]);
+        else if (option == "--seed")
+            seed = std::strtoul(argv[i + 1], 0, 10);
+        else if (option == "--json")
+            jsonPath = argv[i + 1];
+        else {
+            std::cerr << "unknown option " << option << std::endl;
+            return 1;
+        }
+    }
+
+    bench<2>("[1 1 1]", 5, words, seed);
+    bench<4>("[1 1 0 0 1]", 20, words, seed);
+    bench<8>("[1 1 0 0 0 0 1]", 64, words, seed);
+
+    size_t wrong = 0;
+    for (size_t i = 0; i < rows.size(); ++i)
+        wrong += rows[i].wrongLocations + rows[i].wrongWords + rows[i].wrongBatchWords;
+    if (!jsonPath.empty()) {
+        std::ofstream os(jsonPath.c_str());
+        writeJson(os);
+    }
+    return wrong == 0 ? 0 : 2;
+}
@@ -0,0 +1,103 @@
+/*
+ * BenchEncoder.cpp
+ *
+ * Throughput of SystematicEncoder for the Hermitian codes over F_4, F_16,
+ * F_64 and F_256 (r = 2, 4, 8, 16): one word at a time (a matrix-vector
+ * product) and in batches (a matrix-matrix product). The message symbols
+ * are counted as one byte each (the fields have at most 256 elements).
+ *
+ *     g++ -std=c++11 -O2 -DMV_POLY_TRACE_LEVEL=0 -DMV_POLY_PERF_COUNTERS=0 -o BenchEncoder BenchEncoder.cpp -lntl -lglog
+ *     ./BenchEncoder [batch width]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+#include <NTL/GF2.h>
+#include <NTL/GF2E.h>
+
+#include "NtlUtilities.hpp"
+#include "CurveArithmetic.hpp"
+#include "CodeContext.hpp"
+#include "SystematicEncoder.hpp"
+
+using namespace mv_poly;
+
+namespace {
+
+typedef NTL::GF2 PrimeField;
+typedef NTLPrimeFieldTtraits<PrimeField>::ExtField ExtField;
+
+/// Runs \c f until a second passes, returns its calls per second.
+template<typename F>
+double callsPerSecond(F f) {
+    using namespace std::chrono;
+    steady_clock::time_point const start = steady_clock::now();
+    long calls = 0;
+    double seconds = 0;
+    do {
+        f();
+        ++calls;
+        seconds = duration<double>(steady_clock::now() - start).count();
+    } while (seconds < 1);
+    return calls / seconds;
+}
+
+/**
+ * Encodes random messages of the code with \c l checks over the field
+ * given by the primitive polynomial \c field.
+ */
+template<int r>
+void bench(std::string const & field, size_t l, size_t width) {
+    initExtendedField<PrimeField>(field);
+    typedef HermitianCodeParams<r, ExtField> CodeParams;
+    typedef SystematicEncoder<2, CodeParams> EncoderT;
+
+    std::chrono::steady_clock::time_point const start =
+            std::chrono::steady_clock::now();
+    CodeContext<2, CodeParams> const context(l);
+    EncoderT const encoder(context);
+    double const setup = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+    size_t const n = encoder.getLength(), k = encoder.getDimension();
+
+    ExtField const a = FieldElemTraits<ExtField>::getPrimitive();
+    std::vector<typename EncoderT::FieldElemsCollection> messages(width,
+            typename EncoderT::FieldElemsCollection(k));
+    unsigned long seed = 1;
+    for (size_t w = 0; w < width; ++w)
+        for (size_t f = 0; f < k; ++f) {
+            seed = seed * 1103515245 + 12345;
+            messages[w][f] = NTL::power(a, long(seed / 65536 % (r * r - 1)));
+        }
+
+    double const single = callsPerSecond([&encoder, &messages]() {
+        encoder.encode(messages[0]);
+    });
+    double const batch = callsPerSecond([&encoder, &messages]() {
+        encoder.encodeBatch(messages);
+    });
+    std::cout << "r = " << std::setw(2) << r
+              << "  [" << std::setw(4) << n << ", " << std::setw(4) << k << "]"
+              << std::fixed << std::setprecision(2)
+              << "  setup " << std::setw(8) << setup << " s"
+              << "  encode " << std::setw(10) << single * k / 1e6 << " MB/s"
+              << "  encodeBatch(" << width << ") "
+              << std::setw(10) << batch * width * k / 1e6 << " MB/s"
+              << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char * argv[]) {
+    size_t const width = argc > 1 ? std::atoi(argv[1]) : 64;
+    bench<2>("[1 1 1]", 5, width);
+    bench<4>("[1 1 0 0 1]", 20, width);
+    bench<8>("[1 1 0 0 0 0 1]", 64, width);
+    bench<16>("[1 0 1 1 1 0 0 0 1]", 128, width);
+    return 0;
+}
@@ -0,0 +1,187 @@
+/*
+ * BenchKernels.cpp
+ *
+ * Assembly-inspection benchmark for the dimension-specialized kernels
+ * (CoordinateKernels<2|3>, PolyKernels<2|3>) against the generic ones
+ * (GenericCoordinateKernels, GenericPolyKernels).
+ *
+ * Every kernel is wrapped in a non-inlined extern "C" function named
+ * generic_* or unrolled_*, so the code generated for both paths can be put
+ * side by side:
+ *
+ *     g++ -std=c++11 -O2 -S -o BenchKernels.s BenchKernels.cpp
+ *     grep -A40 '^unrolled_less_equal_2:' BenchKernels.s
+ *     grep -A40 '^generic_less_equal_2:' BenchKernels.s
+ *
+ * Built as an executable it reports the time per call of every wrapper:
+ *
+ *     g++ -std=c++11 -O2 -o BenchKernels BenchKernels.cpp -lntl
+ */
+
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+#include "mv_poly.hpp"
+#include "Point.hpp"
+
+using namespace mv_poly;
+
+typedef std::array<long, 2> Impl2;
+typedef std::array<long, 3> Impl3;
+typedef std::array<int, 2> CurvePoint2;
+typedef MVPolyType<2, int>::type Poly2;
+typedef MVPolyType<3, int>::type Poly3;
+
+#define NOINLINE __attribute__((noinline))
+
+extern "C" {
+
+NOINLINE bool generic_less_equal_2(Impl2 const & a, Impl2 const & b) {
+    return GenericCoordinateKernels<2>::lessEqual(a, b);
+}
+
+NOINLINE bool unrolled_less_equal_2(Impl2 const & a, Impl2 const & b) {
+    return CoordinateKernels<2>::lessEqual(a, b);
+}
+
+NOINLINE bool generic_less_equal_3(Impl3 const & a, Impl3 const & b) {
+    return GenericCoordinateKernels<3>::lessEqual(a, b);
+}
+
+NOINLINE bool unrolled_less_equal_3(Impl3 const & a, Impl3 const & b) {
+    return CoordinateKernels<3>::lessEqual(a, b);
+}
+
+NOINLINE bool generic_total_less_2(Impl2 const & a, Impl2 const & b) {
+    return GenericCoordinateKernels<2>::gradedAntilexLess(a, b);
+}
+
+NOINLINE bool unrolled_total_less_2(Impl2 const & a, Impl2 const & b) {
+    return CoordinateKernels<2>::gradedAntilexLess(a, b);
+}
+
+NOINLINE void generic_inc_3(Impl3 & a) {
+    GenericCoordinateKernels<3>::gradedAntilexInc(a);
+}
+
+NOINLINE void unrolled_inc_3(Impl3 & a) {
+    CoordinateKernels<3>::gradedAntilexInc(a);
+}
+
+NOINLINE void generic_add_3(Impl3 & a, Impl3 const & b) {
+    GenericCoordinateKernels<3>::add(a, b);
+}
+
+NOINLINE void unrolled_add_3(Impl3 & a, Impl3 const & b) {
+    CoordinateKernels<3>::add(a, b);
+}
+
+NOINLINE int generic_subscript_2(Poly2 const & p, Point<2> const & pt) {
+    return GenericPolyKernels<2>::subscript(p, pt);
+}
+
+NOINLINE int unrolled_subscript_2(Poly2 const & p, Point<2> const & pt) {
+    return PolyKernels<2>::subscript(p, pt);
+}
+
+NOINLINE int generic_subscript_3(Poly3 const & p, Point<3> const & pt) {
+    return GenericPolyKernels<3>::subscript(p, pt);
+}
+
+NOINLINE int unrolled_subscript_3(Poly3 const & p, Point<3> const & pt) {
+    return PolyKernels<3>::subscript(p, pt);
+}
+
+NOINLINE int generic_eval_2(Poly2 const & p, CurvePoint2 const & cp) {
+    return GenericPolyKernels<2>::eval(p, cp);
+}
+
+NOINLINE int unrolled_eval_2(Poly2 const & p, CurvePoint2 const & cp) {
+    return PolyKernels<2>::eval(p, cp);
+}
+
+NOINLINE void generic_shift_2(Poly2 & p, Point<2> const & m) {
+    GenericPolyKernels<2>::shift(p, m);
+}
+
+NOINLINE void unrolled_shift_2(Poly2 & p, Point<2> const & m) {
+    PolyKernels<2>::shift(p, m);
+}
+
+} // extern "C"
+
+namespace {
+
+const int ITERATIONS = 1000000;
+
+template<typename F>
+void report(std::string const & name, F f, int iterations = ITERATIONS) {
+    using namespace std::chrono;
+    high_resolution_clock::time_point start = high_resolution_clock::now();
+    long sink = 0;
+    for (int i = 0; i < iterations; ++i)
+        sink += f(i);
+    double ns = duration_cast<nanoseconds>(
+            high_resolution_clock::now() - start).count();
+    std::cout << std::left << std::setw(24) << name
+              << std::right << std::setw(10) << std::fixed << std::setprecision(2)
+              << ns / iterations << " ns/call"
+              << "   (" << sink % 10 << ")" << std::endl;
+}
+
+} // namespace
+
+int main() {
+    Impl2 a2 = {{3, 4}}, b2 = {{5, 4}};
+    Impl3 a3 = {{3, 4, 1}}, b3 = {{5, 4, 2}};
+    Poly2 p2("[[1 2 3 4] [5 6 7] [8 9] [10]]");
+    Poly3 p3("[[[1 2] [3 4]] [[5] [6 7]] [[8 9 10]]]");
+    Point<2> pt2 = {2, 1};
+    Point<3> pt3 = {1, 1, 1};
+    CurvePoint2 cp2 = {{2, 3}};
+
+    report("generic_less_equal_2",
+            [&](int i) { a2[0] = i & 7; return generic_less_equal_2(a2, b2); });
+    report("unrolled_less_equal_2",
+            [&](int i) { a2[0] = i & 7; return unrolled_less_equal_2(a2, b2); });
+    report("generic_less_equal_3",
+            [&](int i) { a3[0] = i & 7; return generic_less_equal_3(a3, b3); });
+    report("unrolled_less_equal_3",
+            [&](int i) { a3[0] = i & 7; return unrolled_less_equal_3(a3, b3); });
+    report("generic_total_less_2",
+            [&](int i) { a2[1] = i & 7; return generic_total_less_2(a2, b2); });
+    report("unrolled_total_less_2",
+            [&](int i) { a2[1] = i & 7; return unrolled_total_less_2(a2, b2); });
+    Impl3 g3 = {{0, 0, 0}}, u3 = {{0, 0, 0}};
+    report("generic_inc_3",
+            [&](int) { generic_inc_3(g3); return g3[0]; });
+    report("unrolled_inc_3",
+            [&](int) { unrolled_inc_3(u3); return u3[0]; });
+    report("generic_add_3",
+            [&](int) { generic_add_3(a3, b3); return a3[2]; });
+    report("unrolled_add_3",
+            [&](int) { unrolled_add_3(a3, b3); return a3[2]; });
+    report("generic_subscript_2",
+            [&](int i) { pt2[1] = i & 3; return generic_subscript_2(p2, pt2); });
+    report("unrolled_subscript_2",
+            [&](int i) { pt2[1] = i & 3; return unrolled_subscript_2(p2, pt2); });
+    report("generic_subscript_3",
+            [&](int i) { pt3[2] = i & 3; return generic_subscript_3(p3, pt3); });
+    report("unrolled_subscript_3",
+            [&](int i) { pt3[2] = i & 3; return unrolled_subscript_3(p3, pt3); });
+    report("generic_eval_2",
+            [&](int i) { cp2[0] = i & 7; return generic_eval_2(p2, cp2); });
+    report("unrolled_eval_2",
+            [&](int i) { cp2[0] = i & 7; return unrolled_eval_2(p2, cp2); });
+    const int shifts = 10000;
+    report("generic_shift_2",
+            [&](int) { Poly2 q(p2); generic_shift_2(q, pt2);
+                return q.getPlainDegree(); }, shifts);
+    report("unrolled_shift_2",
+            [&](int) { Poly2 q(p2); unrolled_shift_2(q, pt2);
+                return q.getPlainDegree(); }, shifts);
+}
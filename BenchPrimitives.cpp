@@ -0,0 +1,363 @@
+/*
+ * BenchPrimitives.cpp
+ *
+ * Micro-benchmarks of the polynomial and point primitives: Polynomial +=,
+ * -=, scalar *=, <<= by a point, evaluation at a curve point, conv,
+ * operator==, parsing and printing for 2 and 3 variables over int, ZZ_p
+ * and GF2E; Point::operator++ in the graded and the weighted orders (the
+ * orders of the code basis of Hermitian codes for r = 4, 8 included),
+ * byCoordinateLess, getPartialMaximums and getConjugatePointCollection.
+ *
+ * Every benchmark is run until it takes the given time (0.2 s by default),
+ * the time per operation is reported on stderr and all of them as JSON
+ * (to compare runs of different commits):
+ *
+ *     g++ -std=c++11 -O2 -DMV_POLY_TRACE_LEVEL=0 -o BenchPrimitives BenchPrimitives.cpp -lntl -lglog
+ *     ./BenchPrimitives [--json file] [--min-time seconds] [--filter substring]
+ */
+
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <NTL/GF2.h>
+#include <NTL/GF2E.h>
+#include <NTL/GF2X.h>
+#include <NTL/ZZ.h>
+#include <NTL/ZZ_p.h>
+
+#include "mv_poly.hpp"
+#include "Point.hpp"
+#include "NtlUtilities.hpp"
+#include "TextParser.hpp"
+
+using namespace mv_poly;
+
+namespace {
+
+/// Keeps the compiler from dropping the computation of \c v.
+template<typename T>
+inline void keep(T const & v) {
+    asm volatile("" : : "g"(&v) : "memory");
+}
+
+struct Result {
+    std::string name;
+
+    int dim;
+
+    std::string coef;
+
+    long iterations;
+
+    double nsPerOp;
+};
+
+std::vector<Result> results;
+
+double minSeconds = 0.2;
+
+std::string filter;
+
+long const MAX_ITERATIONS = 1L << 24;
+
+/**
+ * Runs <tt>f(i)</tt> until the calls take minSeconds (or exactly
+ * \c fixedIterations times) and records the time per call.
+ * @return Number of the calls, the calibration ones included.
+ */
+template<typename F>
+long run(std::string const & name, int dim, std::string const & coef, F f,
+        long fixedIterations = 0) {
+    std::ostringstream fullName;
+    fullName << name << '/' << dim << '/' << coef;
+    if (!filter.empty() && fullName.str().find(filter) == std::string::npos)
+        return 0;
+    using namespace std::chrono;
+    long n = fixedIterations > 0 ? fixedIterations : 1, calls = 0;
+    double seconds = 0;
+    for (;;) {
+        steady_clock::time_point const start = steady_clock::now();
+        for (long i = 0; i < n; ++i)
+            f(i);
+        seconds = duration<double>(steady_clock::now() - start).count();
+        calls += n;
+        if (fixedIterations > 0 || seconds >= minSeconds || n >= MAX_ITERATIONS)
+            break;
+        double const estimate = seconds > 0 ? n * 1.2 * minSeconds / seconds : 0;
+        n = std::min(MAX_ITERATIONS, std::max(2 * n, static_cast<long>(estimate)));
+    }
+    Result const result = { name, dim, coef, n, seconds * 1e9 / n };
+    results.push_back(result);
+    std::cerr << std::left << std::setw(40) << fullName.str()
+              << std::right << std::setw(14) << std::fixed << std::setprecision(1)
+              << result.nsPerOp << " ns/op" << std::setw(12) << n << std::endl;
+    return calls;
+}
+
+void writeJson(std::ostream & os) {
+    os << "{\"context\": {\"compiler\": \"" << __VERSION__
+       << "\", \"minTime\": " << minSeconds << "},\n\"benchmarks\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        Result const & r = results[i];
+        os << (i ? ",\n  " : "\n  ")
+           << "{\"name\": \"" << r.name << "\", \"dim\": " << r.dim
+           << ", \"coef\": \"" << r.coef << "\", \"iterations\": "
+           << r.iterations << ", \"nsPerOp\": " << std::fixed << std::setprecision(2)
+           << r.nsPerOp << "}";
+    }
+    os << "\n]}" << std::endl;
+}
+
+/**
+ * \class CoefGen
+ * Coefficients of the benchmarks: the field set up by \c init, a
+ * pseudo-random element \c make, a small one \c small (for the curve
+ * points, so evaluation over int doesn't overflow) and a scalar \c unit
+ * which keeps repeated multiplication bounded.
+ */
+template<typename T>
+struct CoefGen;
+
+template<>
+struct CoefGen<int> {
+    static char const * name() { return "int"; }
+
+    static void init() {}
+
+    static int make(unsigned long r) { return int(r % 17) - 8; }
+
+    static int small(unsigned long r) { return int(r % 3) - 1; }
+
+    static int unit() { return -1; }
+};
+
+template<>
+struct CoefGen<NTL::ZZ_p> {
+    static char const * name() { return "ZZ_p"; }
+
+    static void init() { NTL::ZZ_p::init(NTL::to_ZZ(1000003)); }
+
+    static NTL::ZZ_p make(unsigned long r) {
+        NTL::ZZ_p c;
+        NTL::conv(c, long(r % 1000003));
+        return c;
+    }
+
+    static NTL::ZZ_p small(unsigned long r) { return make(r); }
+
+    static NTL::ZZ_p unit() { return make(3); }
+};
+
+template<>
+struct CoefGen<NTL::GF2E> {
+    static char const * name() { return "GF2E"; }
+
+    static void init() { initExtendedField<NTL::GF2>("[1 0 1 1 1 0 0 0 1]"); }
+
+    static NTL::GF2E make(unsigned long r) {
+        NTL::GF2X x;
+        for (int b = 0; b < 8; ++b)
+            if ((r >> b) & 1)
+                NTL::SetCoeff(x, b);
+        NTL::GF2E c;
+        NTL::conv(c, x);
+        return c;
+    }
+
+    static NTL::GF2E small(unsigned long r) { return make(r); }
+
+    static NTL::GF2E unit() { return make(2); }
+};
+
+/// Dense polynomial with \c side coefficients in every variable.
+template<int Dim, typename T>
+typename MVPolyType<Dim, T>::type randomPoly(long side, unsigned long seed) {
+    std::array<long, Dim> extents;
+    extents.fill(side);
+    std::vector<T> coefs;
+    long size = 1;
+    for (int i = 0; i < Dim; ++i)
+        size *= side;
+    for (long i = 0; i < size; ++i) {
+        seed = seed * 6364136223846793005ul + 1442695040888963407ul;
+        coefs.push_back(CoefGen<T>::make(seed >> 33));
+    }
+    return from_dense<typename MVPolyType<Dim, T>::type>(coefs, extents);
+}
+
+template<int Dim, typename T>
+void benchPolynomial(long side) {
+    typedef CoefGen<T> Gen;
+    typedef typename MVPolyType<Dim, T>::type PolyT;
+    Gen::init();
+    std::string const coef = Gen::name();
+    PolyT a = randomPoly<Dim, T>(side, 1);
+    PolyT const b = randomPoly<Dim, T>(side, 2);
+    PolyT const a2(a);
+
+    // -= undoes += (the int coefficients stay bounded), so subtract runs
+    // only as many times as add did, not at all if add is filtered out
+    long const adds = run("poly.add", Dim, coef, [&](long) { a += b; });
+    if (adds > 0)
+        run("poly.subtract", Dim, coef, [&](long) { a -= b; }, adds);
+    T const c = Gen::unit();
+    run("poly.scalarMultiply", Dim, coef, [&](long) { a *= c; });
+    a = a2;
+    run("poly.copy", Dim, coef, [&](long) { PolyT q(a); keep(q); });
+    Point<Dim> m;
+    for (int i = 0; i < Dim; ++i)
+        m[i] = i + 1;
+    run("poly.shiftByPoint", Dim, coef, [&](long) {
+        PolyT q(a);
+        q <<= m;
+        keep(q);
+    });
+
+    std::array<T, Dim> cp;
+    for (int i = 0; i < Dim; ++i)
+        cp[i] = Gen::small(i + 2);
+    run("poly.evalAtCurvePoint", Dim, coef, [&](long) { keep(a(cp)); });
+
+    Point<Dim> degf, shift;
+    for (int i = 0; i < Dim; ++i) {
+        degf[i] = side / 2;
+        shift[i] = 1;
+    }
+    Point<Dim> const convAt = degf + shift;
+    run("poly.conv", Dim, coef, [&](long) { keep(conv<T>(a, b, degf, convAt)); });
+    run("poly.equal", Dim, coef, [&](long) { keep(a == a2); });
+
+    std::ostringstream text;
+    text << a;
+    std::string const s = text.str();
+    run("poly.parseStream", Dim, coef, [&](long) {
+        std::istringstream is(s);
+        PolyT q;
+        is >> q;
+        keep(q);
+    });
+    run("poly.parseBuffer", Dim, coef, [&](long) {
+        PolyT q;
+        parsePolynomial(s, q);
+        keep(q);
+    });
+    run("poly.print", Dim, coef, [&](long) {
+        std::ostringstream os;
+        os << a;
+        keep(os);
+    });
+}
+
+/// Pseudo-random points with coordinates below \c bound.
+template<int Dim, template <typename> class OrderPolicy>
+std::vector< Point<Dim, OrderPolicy> > randomPoints(size_t cnt, long bound) {
+    std::vector< Point<Dim, OrderPolicy> > points(cnt);
+    unsigned long seed = 7;
+    for (size_t p = 0; p < cnt; ++p)
+        for (int i = 0; i < Dim; ++i) {
+            seed = seed * 6364136223846793005ul + 1442695040888963407ul;
+            points[p][i] = (seed >> 33) % bound;
+        }
+    return points;
+}
+
+template<int Dim>
+void benchPoint() {
+    std::string const coef = "-";
+    Point<Dim> graded;
+    run("point.incrementGraded", Dim, coef, [&](long) { ++graded; keep(graded); });
+
+    std::vector< Point<Dim> > const points = randomPoints<Dim, GradedAntilexMonomialOrder>(64, 8);
+    run("point.byCoordinateLess", Dim, coef, [&](long i) {
+        keep(byCoordinateLess(points[i & 63], points[(i + 1) & 63]));
+    });
+    run("point.partialMaximums", Dim, coef, [&](long) {
+        keep(getPartialMaximums(points));
+    });
+    std::vector< Point<Dim> > const staircase = getPartialMaximums(
+            randomPoints<Dim, GradedAntilexMonomialOrder>(16, 6));
+    run("point.conjugatePointCollection", Dim, coef, [&](long) {
+        keep(getConjugatePointCollection(staircase));
+    });
+}
+
+/**
+ * The order of the code basis of the Hermitian code of \c r (cf.
+ * HermitianCodeParams): ++ visits only the canonical points (the first
+ * coordinate below r + 1) and getConjugatePointCollection skips the other
+ * ones by Point::isCanonical.
+ */
+template<int r>
+void benchCodeOrderPoint() {
+    std::ostringstream suffix;
+    suffix << "R" << r;
+    typedef Point<2, WeightedOrder<r, r + 1>::template impl> WPt;
+    WPt weighted;
+    run("point.incrementWeighted" + suffix.str(), 2, "-", [&](long) {
+        ++weighted;
+        keep(weighted);
+    });
+    std::vector<WPt> const staircase = getPartialMaximums(
+            randomPoints<2, WeightedOrder<r, r + 1>::template impl>(16, r + 1));
+    run("point.conjugatePointCollectionWeighted" + suffix.str(), 2, "-", [&](long) {
+        keep(getConjugatePointCollection(staircase));
+    });
+}
+
+/// The weighted orders are for two variables only.
+void benchWeightedPoint() {
+    typedef Point<2, WeightedMonomialOrder<4, 5>::impl> WPt;
+    WPt weighted;
+    run("point.incrementWeighted", 2, "-", [&](long) { ++weighted; keep(weighted); });
+    std::vector<WPt> const staircase = getPartialMaximums(
+            randomPoints<2, WeightedMonomialOrder<4, 5>::impl>(16, 6));
+    run("point.conjugatePointCollectionWeighted", 2, "-", [&](long) {
+        keep(getConjugatePointCollection(staircase));
+    });
+    benchCodeOrderPoint<4>();
+    benchCodeOrderPoint<8>();
+}
+
+} // namespace
+
+int main(int argc, char * argv[]) {
+    std::string jsonPath;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string const option = argv[i];
+        if (option == "--json")
+            jsonPath = argv[i + 1];
+        else if (option == "--min-time")
+            minSeconds = std::atof(argv[i + 1]);
+        else if (option == "--filter")
+            filter = argv[i + 1];
+        else {
+            std::cerr << "unknown option " << option << std::endl;
+            return 1;
+        }
+    }
+
+    benchPolynomial<2, int>(8);
+    benchPolynomial<3, int>(4);
+    benchPolynomial<2, NTL::ZZ_p>(8);
+    benchPolynomial<3, NTL::ZZ_p>(4);
+    benchPolynomial<2, NTL::GF2E>(8);
+    benchPolynomial<3, NTL::GF2E>(4);
+    benchPoint<2>();
+    benchPoint<3>();
+    benchWeightedPoint();
+
+    if (jsonPath.empty())
+        writeJson(std::cout);
+    else {
+        std::ofstream os(jsonPath.c_str());
+        writeJson(os);
+    }
+    return 0;
+}
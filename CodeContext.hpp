@@ -0,0 +1,212 @@
+/**
+ * @file CodeContext.hpp
+ *
+ * Tables of an algebraic-geometric code computed once and shared by its
+ * decoders (cf. BMSDecoding).
+ */
+
+#ifndef CODECONTEXT_HPP_
+#define CODECONTEXT_HPP_
+
+#include <algorithm>
+#include <vector>
+
+#include <glog/logging.h>
+
+#include "Point.hpp"
+#include "CoefficientTraits.hpp"
+#include "NtlPolynomials.hpp"
+#include "SequenceView.hpp"
+#include "Trace.hpp"
+
+namespace mv_poly {
+
+/**
+ * \class CodeContext
+ * Everything about the code with \c l checks that doesn't depend on the
+ * received word: the rational points, the basis, the Feng-Rao bound, the
+ * points of the known syndromes in the monomial order with their ranks,
+ * the powers of the coordinates of the points and the parity-check matrix.
+ *
+ * The context is built by the constructor and never changes afterwards, so
+ * one context can be shared by any number of decoders in any number of
+ * threads (each thread still has to install the field modulus if the
+ * field implementation keeps it per thread, as NTL does).
+ *
+ * @param Dim Dimension of point lattice.
+ * @param ECCodeParams Code parameters (cf. HermitianCodeParams).
+ */
+template<int Dim, typename ECCodeParams>
+class CodeContext {
+public:
+    typedef typename ECCodeParams::Field Field;
+
+    typedef typename ECCodeParams::BasisCollection BasisCollection;
+
+    typedef typename ECCodeParams::CurvePoint CurvePoint;
+
+    typedef std::vector<CurvePoint> CurvePointsCollection;
+
+    typedef Point<Dim, ECCodeParams::LatticeOrderPolicyHolder::template impl>
+        LatticePointT;
+
+    explicit CodeContext(size_t l_) :
+            l(l_),
+            curvePoints(ECCodeParams::getRationalPoints()),
+            basis(ECCodeParams::getCodeBasis(l_)),
+            knownWeight(ECCodeParams::weight(basis.back())),
+            correctable((computeFengRaoDistance(knownWeight) - 1) / 2),
+            locatorWeight(std::max(knownWeight,
+                    ECCodeParams::getLocatorWeight(correctable))),
+            groupOrder(ECCodeParams::getFieldSize() - 1) {
+        Field const one = FieldElemTraits<Field>::multId();
+
+        // powers of the coordinates up to the order of the multiplicative
+        // group: the other ones repeat them
+        powers.reserve(curvePoints.size() * Dim * (groupOrder + 1));
+        for (size_t p = 0; p < curvePoints.size(); ++p)
+            for (int i = 0; i < Dim; ++i) {
+                Field x = one;
+                for (long e = 0; e <= groupOrder; ++e) {
+                    powers.push_back(x);
+                    x *= curvePoints[p][i];
+                }
+            }
+
+        // points of the known syndromes: the whole plane up to the weight
+        // of the last basis element
+        typename BoxLayout<Dim>::Extents extents;
+        extents.fill(0);
+        for (LatticePointT pt; ECCodeParams::weight(pt) <= knownWeight; ++pt) {
+            syndromePoints.push_back(pt);
+            for (int i = 0; i < Dim; ++i)
+                extents[i] = std::max(extents[i], pt[i] + 1);
+        }
+        rankLayout = BoxLayout<Dim>(extents);
+        ranks.assign(rankLayout.size(), -1);
+        for (size_t k = 0; k < syndromePoints.size(); ++k)
+            ranks[rankLayout.rank(syndromePoints[k])] = k;
+
+        parityCheck.reserve(syndromePoints.size() * curvePoints.size());
+        for (size_t k = 0; k < syndromePoints.size(); ++k)
+            for (size_t p = 0; p < curvePoints.size(); ++p)
+                parityCheck.push_back(monomial(syndromePoints[k], p));
+
+        // Logging
+        MV_POLY_LOG(MV_POLY_TRACE_STEPS) << "Curve points";
+        if (MV_POLY_TRACE_ENABLED(MV_POLY_TRACE_STEPS))
+            for (auto cpt : curvePoints) {
+                LOG(INFO) << "("
+                          << makeNtlPowerPrinter(cpt[0])  << ", "
+                          << makeNtlPowerPrinter(cpt[1])   << ")";
+            }
+        MV_POLY_LOG(MV_POLY_TRACE_SUMMARY) << "Code with " << l
+                << " checks corrects " << correctable << " errors";
+    }
+
+    /// Number of checks.
+    size_t getCheckCnt() const { return l; }
+
+    CurvePointsCollection const & getCurvePoints() const { return curvePoints; }
+
+    BasisCollection const & getBasis() const { return basis; }
+
+    /// Weight of the last basis element (the syndromes up to it are known).
+    long getKnownWeight() const { return knownWeight; }
+
+    /// Number of errors the code corrects: half the Feng-Rao distance.
+    int getCorrectable() const { return correctable; }
+
+    /// Weight of the syndromes the error locator ideal is found from.
+    long getLocatorWeight() const { return locatorWeight; }
+
+    /// Points of the known syndromes following the monomial order.
+    std::vector<LatticePointT> const & getSyndromePoints() const {
+        return syndromePoints;
+    }
+
+    /// Index of \c pt in getSyndromePoints, -1 if it isn't there.
+    long rank(LatticePointT const & pt) const {
+        return rankLayout.contains(pt) ? ranks[rankLayout.rank(pt)] : -1;
+    }
+
+    /// <tt>getCurvePoints()[p][i]^e</tt> looked up in the tables.
+    Field const & power(size_t p, int i, long e) const {
+        size_t const row = (p * Dim + i) * (groupOrder + 1);
+        return powers[e == 0 ? row : row + (e - 1) % groupOrder + 1];
+    }
+
+    /// Monomial of degree \c m at the \c p-th point (cf. computeMonomAtPoint).
+    template<typename Pt>
+    Field monomial(Pt const & m, size_t p) const {
+        Field result = power(p, 0, m[0]);
+        for (int i = 1; i < Dim; ++i)
+            result *= power(p, i, m[i]);
+        return result;
+    }
+
+    /**
+     * Parity-check matrix of the code extended to the plane: the rows are
+     * the monomials of getSyndromePoints at the points (row-major), so the
+     * known syndromes of a word are the product of the matrix by it.
+     */
+    std::vector<Field> const & getParityCheckMatrix() const {
+        return parityCheck;
+    }
+
+private:
+    /**
+     * Feng-Rao designed distance of the code: the least number of pairs of
+     * basis elements with the sum of weights equal to the weight of an
+     * unknown syndrome.
+     */
+    static int computeFengRaoDistance(long knownWeight) {
+        typedef typename BasisCollection::value_type BasisElem;
+        long const bound = knownWeight + 4 * ECCodeParams::getGenus() + 2;
+        std::vector<long> weights;
+        for (BasisElem be; ECCodeParams::weight(be) <= bound; ++be)
+            weights.push_back(ECCodeParams::weight(be));
+        int result = -1;
+        for (size_t c = 0; c < weights.size(); ++c) {
+            if (weights[c] <= knownWeight)
+                continue;
+            int pairs = 0;
+            for (size_t i = 0; i < weights.size(); ++i)
+                pairs += std::binary_search(weights.begin(), weights.end(),
+                        weights[c] - weights[i]);
+            if (result < 0 || pairs < result)
+                result = pairs;
+        }
+        return result;
+    }
+
+    size_t const l;
+
+    CurvePointsCollection const curvePoints;
+
+    BasisCollection const basis;
+
+    long const knownWeight;
+
+    int const correctable;
+
+    long const locatorWeight;
+
+    /// Order of the multiplicative group of the field.
+    long const groupOrder;
+
+    /// Powers 0..groupOrder of every coordinate of every point.
+    std::vector<Field> powers;
+
+    std::vector<LatticePointT> syndromePoints;
+
+    BoxLayout<Dim> rankLayout;
+
+    std::vector<long> ranks;
+
+    std::vector<Field> parityCheck;
+};
+
+} // namespace mv_poly
+
+#endif /* CODECONTEXT_HPP_ */
@@ -43,44 +43,74 @@ bool isPlainHermitianCurveRationalPoint(int r, CurvePoint cp) {
     return FieldElemTraits<FieldElem>::power(cp[0], r + 1) -
             FieldElemTraits<FieldElem>::power(cp[1], r) - cp[1] ==
                     FieldElemTraits<FieldElem>::addId();
-    // TODO: repetitive computations of x^n are ineffective
 }
 
+/**
+ * Rational points of the Hermitian curve x^{r+1} = y^r + y over F_{r^2}:
+ * (0, 0), then (0, y) and (x, y) with x and y running over the powers of
+ * the primitive element a in the order of the exponents (the positions of
+ * the code follow this order).
+ *
+ * Both sides of the equation are in F_r: the norm x^{r+1} of x = a^i is
+ * c_m = a^{(r+1)m} with m = i mod (r-1), and the trace y^r + y of every
+ * y is found once. So the solutions y of y^r + y = c_m are listed once
+ * per m and repeated for all the x with that norm: O(r^3) operations for
+ * the r^3 points, with no powers computed.
+ */
 template<int r, typename CurvePoint, typename FieldElem>
 std::vector<CurvePoint>
 getPlainHermitianCurveRationalPoints() {
-//    auto power = &FieldElemTraits<FieldElem>::power;
-    FieldElem x = FieldElemTraits<FieldElem>::getPrimitive();
+    typedef FieldElemTraits<FieldElem> FieldTr;
+    FieldElem const a = FieldTr::getPrimitive();
+    FieldElem const zero = FieldTr::addId();
+    FieldElem const id = FieldTr::multId();
+    long const groupOrder = r * r - 1;
+
+    // norms of the powers of a: c_m = a^{(r+1)m}, m < r - 1
+    std::vector<FieldElem> norms;
+    FieldElem const normStep = FieldTr::power(a, r + 1);
+    FieldElem c = id;
+    for (int m = 0; m < r - 1; ++m, c *= normStep)
+        norms.push_back(c);
+
+    // solutions of y^r + y = 0 (y = a^j) and of y^r + y = c_m
+    std::vector<FieldElem> kernel;
+    std::vector< std::vector<FieldElem> > solutions(norms.size());
+    FieldElem const rStep = FieldTr::power(a, r);
+    FieldElem y = id, yr = id;  // a^j and a^{jr}
+    for (long j = 0; j < groupOrder; ++j, y *= a, yr *= rStep) {
+        FieldElem const trace = yr + y;
+        if (trace == zero) {
+            kernel.push_back(y);
+            continue;
+        }
+        for (size_t m = 0; m < norms.size(); ++m)
+            if (trace == norms[m]) {
+                solutions[m].push_back(y);
+                break;
+            }
+    }
+
     std::vector<CurvePoint> result;
-    FieldElem zero = FieldElemTraits<FieldElem>::addId();
-    FieldElem id = FieldElemTraits<FieldElem>::multId();
+    result.reserve(r * r * r);
     CurvePoint cp;
 
     cp[0] = zero;
     cp[1] = zero;
     result.push_back(cp);
+    for (size_t k = 0; k < kernel.size(); ++k) {
+        cp[1] = kernel[k];
+        result.push_back(cp);
+    }
 
-    cp[0] = zero;
-    cp[1] = id;
-    do {
-        if (isPlainHermitianCurveRationalPoint<FieldElem>(r, cp)) {
+    cp[0] = id;
+    for (long i = 0; i < groupOrder; ++i, cp[0] *= a) {
+        std::vector<FieldElem> const & ys = solutions[i % norms.size()];
+        for (size_t k = 0; k < ys.size(); ++k) {
+            cp[1] = ys[k];
             result.push_back(cp);
         }
-        cp[1] *= x;
-    } while (cp[1] != id);
-
-    cp[0] = id;
-    do {
-        cp[1] = id;
-        do {
-            if (isPlainHermitianCurveRationalPoint<FieldElem>(r, cp)) {
-                result.push_back(cp);
-            }
-            cp[1] *= x;
-        } while (cp[1] != id);
-
-        cp[0] *= x;
-    } while (cp[0] != id);
+    }
 
     return result;
 }
@@ -106,6 +136,10 @@ struct HermitianCodeParams {
 
     typedef WeightedOrder<r, r + 1> OrderPolicyHolder;
 
+    /// Order of the whole plane with the same weights (x^{r+1} > y^r), the
+    /// syndromes are extended to the plane by the curve equation.
+    typedef WeightedMonomialOrder<r, r + 1> LatticeOrderPolicyHolder;
+
     typedef WeightedBasisCollection<DIM, r, r+1> BasisCollection;
 
     typedef typename BasisCollection::value_type BasisElem;
@@ -126,6 +160,57 @@ struct HermitianCodeParams {
         return getPlainHermitianCurveRationalPoints<r, CurvePoint, FieldElem>();
     }
 
+    static int getGenus() {
+        return r * (r - 1) / 2;
+    }
+
+    /// Number of elements of the field (q^2 with q = r).
+    static long getFieldSize() {
+        return r * r;
+    }
+
+    /// Pole order of the monomial x^pt[0] y^pt[1] at the point at infinity.
+    template<typename Pt>
+    static long weight(Pt const & pt) {
+        return r * pt[0] + (r + 1) * pt[1];
+    }
+
+    /// The monomial x^pt is a basis element (the exponent of x is at most r).
+    template<typename Pt>
+    static bool isBasisElem(Pt const & pt) {
+        return pt[0] <= r;
+    }
+
+    /**
+     * Reduces the monomial x^pt by the curve equation x^{r+1} = y^r + y:
+     * if pt isn't a basis element (the exponent of x exceeds r), then
+     * x^pt = x^same + x^lower on the curve, \c same having the same weight
+     * and \c lower the lesser one.
+     * @return False if \c pt is a basis element (nothing to reduce).
+     */
+    template<typename Pt>
+    static bool reduceByCurve(Pt const & pt, Pt & same, Pt & lower) {
+        if (isBasisElem(pt))
+            return false;
+        same = lower = pt;
+        same[0] -= r + 1;
+        same[1] += r;
+        lower[0] -= r + 1;
+        lower[1] += 1;
+        return true;
+    }
+
+    /**
+     * Weight of the syndromes which determine the error locator ideal for at
+     * most \c t errors: its delta-set has \c t points at most and lies in
+     * the strip where the exponent of x is at most r, so the points of the
+     * delta-set weigh (r+1)(t-1) at most and the leading monomials of the
+     * Groebner basis weigh max((r+1)t, r(r+1)) at most.
+     */
+    static long getLocatorWeight(int t) {
+        return std::max<long>((r + 1) * t, r * (r + 1)) + (r + 1) * std::max(t - 1, 0);
+    }
+
 };
 
 } // namespace mv_poly
@@ -0,0 +1,289 @@
+/**
+ * @file DenseSequence.hpp
+ *
+ * Dense multi-indexed sequence to be used as an input of BMS-algorithm
+ * (e.g. syndromes in decoding) instead of a map from points to elements
+ * or a Polynomial.
+ */
+
+#ifndef DENSESEQUENCE_HPP_
+#define DENSESEQUENCE_HPP_
+
+#include <algorithm>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <cassert>
+
+#include "mv_poly.hpp"
+#include "Point.hpp"
+#include "CoefficientTraits.hpp"
+#include "SequenceView.hpp"
+
+namespace mv_poly {
+
+/**
+ * \class DenseSequence
+ * Sequence indexed by points of the lattice and stored in a contiguous array
+ * in the box layout (cf. BoxLayout), so that element access is O(1).
+ * Elements are usually appended one by one following the monomial order
+ * (as syndromes become known); the box grows geometrically when a point
+ * outside of it is set. Points that were never set read as zero.
+ *
+ * The class has the interface BMSAlgorithm, \c conv, \c convSupport and
+ * \c mapToStr expect from the sequence.
+ *
+ * @param Dim Dimension of point lattice.
+ * @param Coef Sequence element type.
+ * @param OrderPolicy Monomial order used for appending.
+ */
+template<
+    int Dim,
+    typename Coef,
+    template <typename PointImpl> class OrderPolicy = GradedAntilexMonomialOrder
+>
+class DenseSequence {
+public:
+    typedef Point<Dim, OrderPolicy> PointT;
+
+    typedef Coef CoefT;
+
+    /// STL-compliant typedef for map-like types (used by \c conv).
+    typedef Coef mapped_type;
+
+    typedef BoxLayout<Dim> LayoutT;
+
+    /// Creates empty sequence.
+    DenseSequence() : ZERO(CoefficientTraits<Coef>::addId()) {}
+
+    /**
+     * Creates sequence with elements equal to the coefficients of \c p, the
+     * sequence is considered known up to the greatest stored coefficient.
+     */
+    template<typename T>
+    explicit DenseSequence(Polynomial<T> const & p) :
+            ZERO(CoefficientTraits<Coef>::addId()) {
+        forEachCoefficient<PointT>(p,
+                [this](PointT const & pt, Coef const & c) {
+                    this->set(pt, c);
+                });
+    }
+
+    /**
+     * Creates sequence with elements from the map (e.g. syndromes), the
+     * sequence is considered known up to the greatest key.
+     */
+    template<typename Pt, typename Cmp, typename Alloc>
+    explicit DenseSequence(std::map<Pt, Coef, Cmp, Alloc> const & m) :
+            ZERO(CoefficientTraits<Coef>::addId()) {
+        typedef typename std::map<Pt, Coef, Cmp, Alloc>::const_iterator It;
+        for (It it = m.begin(); it != m.end(); ++it)
+            set(toPoint(it->first), it->second);
+    }
+
+    /// Element at \c pt, zero if it was never set.
+    Coef const & operator[](PointT const & pt) const {
+        return layout.contains(pt) ? values[layout.rank(pt)] : ZERO;
+    }
+
+    /// Element at \c pt, which must be inside of the box (cf. \c contains).
+    template<typename Pt>
+    Coef const & unchecked(Pt const & pt) const {
+        assert(layout.contains(pt));
+        return values[layout.rank(pt)];
+    }
+
+    /// Checks if \c pt is inside of the currently allocated box.
+    template<typename Pt>
+    bool contains(Pt const & pt) const {
+        return layout.contains(pt);
+    }
+
+    /**
+     * Sets element at \c pt. If \c pt is not less than the end of known
+     * prefix (cf. \c getEnd), the prefix is extended up to \c pt.
+     */
+    void set(PointT const & pt, Coef const & c) {
+        reserve(pt);
+        values[layout.rank(pt)] = c;
+        if (!(pt < end)) {
+            end = pt;
+            ++end;
+        }
+    }
+
+    /// Appends next element (following the monomial order).
+    void push_back(Coef const & c) {
+        set(end, c);
+    }
+
+    /// Point next to the last known element (w.r.t. the monomial order).
+    PointT const & getEnd() const { return end; }
+
+    /// Ensures the box contains \c pt so that setting it doesn't reallocate.
+    void reserve(PointT const & pt) {
+        if (layout.contains(pt))
+            return;
+        typename LayoutT::Extents extents = layout.getExtents();
+        for (int i = 0; i < Dim; ++i) {
+            assert(pt[i] >= 0);
+            if (extents[i] <= pt[i])
+                extents[i] = std::max(2 * extents[i], pt[i] + 1);
+        }
+        relayout(extents);
+    }
+
+    LayoutT const & getLayout() const { return layout; }
+
+    /// Point of the sequence with the same coordinates as \c pt.
+    template<typename Pt>
+    static PointT toPoint(Pt const & pt) {
+        PointT result;
+        for (int i = 0; i < Dim; ++i)
+            result[i] = pt[i];
+        return result;
+    }
+
+private:
+    void relayout(typename LayoutT::Extents const & extents) {
+        LayoutT newLayout(extents);
+        std::vector<Coef> newValues(newLayout.size(), ZERO);
+        PointT pt;
+        for (long r = 0; r < (long)values.size(); ++r) {
+            layout.unrank(r, pt);
+            newValues[newLayout.rank(pt)] = values[r];
+        }
+        layout = newLayout;
+        values.swap(newValues);
+    }
+
+    Coef ZERO;
+
+    LayoutT layout;
+
+    std::vector<Coef> values;
+
+    PointT end;
+};
+
+/**
+ * Dense random-access form of a sequence of type \c SeqT for \c convSupport.
+ * Generally the sequence (a Polynomial or a map) is copied into
+ * DenseSequence on \c refresh and is kept up to date by \c update as
+ * elements are appended; DenseSequence itself is used directly.
+ */
+template<typename SeqT, int Dim, typename Coef>
+class SequenceViewHolder {
+public:
+    typedef DenseSequence<Dim, Coef> ViewT;
+
+    /// Makes the view reflect the current contents of \c seq.
+    void refresh(SeqT const & seq) {
+        view = ViewT(seq);
+    }
+
+    /// Reflects <tt>seq[pt] = c</tt> in the view.
+    template<typename Pt>
+    void update(SeqT const &, Pt const & pt, Coef const & c) {
+        view.set(ViewT::toPoint(pt), c);
+    }
+
+    ViewT const & get(SeqT const &) const {
+        return view;
+    }
+
+private:
+    ViewT view;
+};
+
+/// DenseSequence is read by \c convSupport as it is, without copying.
+template<int Dim, typename Coef, template <typename PointImpl> class OrderPolicy>
+class SequenceViewHolder<DenseSequence<Dim, Coef, OrderPolicy>, Dim, Coef> {
+public:
+    typedef DenseSequence<Dim, Coef, OrderPolicy> ViewT;
+
+    void refresh(ViewT const &) {}
+
+    template<typename Pt>
+    void update(ViewT const &, Pt const &, Coef const &) {}
+
+    ViewT const & get(ViewT const & seq) const {
+        return seq;
+    }
+};
+
+/**
+ * Sets the element of the sequence at \c pt: overloaded for the types of
+ * sequences BMSAlgorithm works with (maps, polynomials, DenseSequence).
+ */
+template<typename Pt, typename Coef, typename Cmp, typename Alloc, typename Pt1>
+void setSequenceElement(
+        std::map<Pt, Coef, Cmp, Alloc> & seq,
+        Pt1 const & pt,
+        Coef const & c) {
+    seq[pt] = c;
+}
+
+template<typename T, typename Pt>
+void setSequenceElement(
+        Polynomial<T> & seq,
+        Pt const & pt,
+        typename Polynomial<T>::CoefT const & c) {
+    setCoefficient(seq, pt, c);
+}
+
+/**
+ * Element of the sequence at \c pt (zero if absent) read without
+ * modifying the sequence.
+ */
+template<typename Pt, typename Coef, typename Cmp, typename Alloc, typename Pt1>
+Coef getSequenceElement(
+        std::map<Pt, Coef, Cmp, Alloc> const & seq,
+        Pt1 const & pt) {
+    typename std::map<Pt, Coef, Cmp, Alloc>::const_iterator it = seq.find(pt);
+    return it != seq.end() ? it->second : CoefficientTraits<Coef>::addId();
+}
+
+template<typename T, typename Pt>
+typename Polynomial<T>::CoefT getSequenceElement(
+        Polynomial<T> const & seq,
+        Pt const & pt) {
+    return seq[pt];
+}
+
+template<int Dim, typename Coef, template <typename PointImpl> class OrderPolicy,
+    typename Pt>
+Coef getSequenceElement(
+        DenseSequence<Dim, Coef, OrderPolicy> const & seq,
+        Pt const & pt) {
+    return seq[DenseSequence<Dim, Coef, OrderPolicy>::toPoint(pt)];
+}
+
+template<int Dim, typename Coef, template <typename PointImpl> class OrderPolicy,
+    typename Pt>
+void setSequenceElement(
+        DenseSequence<Dim, Coef, OrderPolicy> & seq,
+        Pt const & pt,
+        Coef const & c) {
+    seq.set(DenseSequence<Dim, Coef, OrderPolicy>::toPoint(pt), c);
+}
+
+/**
+ * String representation of the known prefix of the sequence in the same
+ * format as of \c mapToStr for maps: “pt : value pt' : value' …”.
+ */
+template<int Dim, typename Coef, template <typename PointImpl> class OrderPolicy>
+std::string mapToStr(DenseSequence<Dim, Coef, OrderPolicy> const & seq) {
+    std::ostringstream oss;
+    for (Point<Dim, OrderPolicy> pt; pt < seq.getEnd(); ++pt)
+        oss
+              << pt  << " : "
+              << seq[pt] << " ";
+    return oss.str();
+}
+
+} // namespace mv_poly
+
+#endif /* DENSESEQUENCE_HPP_ */
@@ -0,0 +1,219 @@
+/**
+ * @file Executor.hpp
+ *
+ * Work-stealing thread pool used to run independent parts of one step of
+ * BMS-algorithm (discrepancies, new polynomials of F) in parallel.
+ */
+
+#ifndef EXECUTOR_HPP_
+#define EXECUTOR_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <cstddef>
+
+namespace mv_poly {
+
+/**
+ * \class WorkStealingPool
+ * Pool of worker threads, each owning a deque of tasks. A thread pushes and
+ * pops tasks at the back of its own deque and, when it is empty, steals
+ * from the front of the others. Threads that are not workers of the pool
+ * (e.g. the one calling \c parallelFor) use a shared deque and take part
+ * in running tasks while waiting for their batch.
+ *
+ * The pool doesn't impose any order of execution, so the callers should
+ * write the results to distinct slots and merge them afterwards.
+ *
+ * NTL keeps moduli (ZZ_p, GF2E) per thread, so for such coefficients the
+ * workers should restore the context of the creating thread, e.g.:
+ * \code
+ * NTL::GF2EContext context;
+ * context.save();
+ * WorkStealingPool pool(4, [context]() { context.restore(); });
+ * \endcode
+ */
+class WorkStealingPool {
+public:
+    typedef std::function<void ()> Task;
+
+    /**
+     * Starts \c threadCnt workers; with zero workers \c parallelFor runs
+     * everything in the calling thread.
+     * @param threadCnt Number of worker threads.
+     * @param threadInit Called by every worker before running tasks.
+     */
+    explicit WorkStealingPool(
+            unsigned threadCnt = std::thread::hardware_concurrency(),
+            Task const & threadInit = Task()) :
+                queues(threadCnt + 1), pending(0), done(false) {
+        for (unsigned i = 0; i < threadCnt; ++i)
+            threads.push_back(
+                    std::thread(&WorkStealingPool::work, this, i + 1, threadInit));
+    }
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            done = true;
+        }
+        wakeUp.notify_all();
+        for (size_t i = 0; i < threads.size(); ++i)
+            threads[i].join();
+    }
+
+    unsigned getThreadCnt() const {
+        return threads.size();
+    }
+
+    /**
+     * Calls <tt>body(i)</tt> for every i in [0, n) and returns when all the
+     * calls are finished. The calling thread runs tasks as well, so nested
+     * \c parallelFor from a task doesn't deadlock. The first exception thrown
+     * by \c body is rethrown here.
+     */
+    template<typename Body>
+    void parallelFor(size_t n, Body const & body) {
+        if (threads.empty() || n < 2) {
+            for (size_t i = 0; i < n; ++i)
+                body(i);
+            return;
+        }
+        Batch batch(n);
+        for (size_t i = 0; i < n; ++i)
+            push([&batch, &body, i]() {
+                try {
+                    body(i);
+                } catch (...) {
+                    batch.fail(std::current_exception());
+                }
+                --batch.remaining;
+            });
+        size_t const own = ownQueue();
+        while (batch.remaining > 0)
+            if (!tryRun(own))
+                std::this_thread::yield();
+        if (batch.error)
+            std::rethrow_exception(batch.error);
+    }
+
+private:
+    WorkStealingPool(WorkStealingPool const &);
+
+    WorkStealingPool & operator=(WorkStealingPool const &);
+
+    struct WorkQueue {
+        std::mutex mutex;
+
+        std::deque<Task> tasks;
+    };
+
+    /// Tasks of one \c parallelFor call.
+    struct Batch {
+        explicit Batch(size_t n) : remaining(n) {}
+
+        void fail(std::exception_ptr e) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error)
+                error = e;
+        }
+
+        std::atomic<size_t> remaining;
+
+        std::mutex errorMutex;
+
+        std::exception_ptr error;
+    };
+
+    struct WorkerId {
+        WorkStealingPool const * pool;
+
+        size_t queue;
+    };
+
+    static WorkerId & currentWorker() {
+        static thread_local WorkerId id = { 0, 0 };
+        return id;
+    }
+
+    /// Deque of the current thread: its own for workers, shared otherwise.
+    size_t ownQueue() const {
+        WorkerId const & id = currentWorker();
+        return id.pool == this ? id.queue : 0;
+    }
+
+    void push(Task const & task) {
+        WorkQueue & queue = queues[ownQueue()];
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.push_back(task);
+        }
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            ++pending;
+        }
+        wakeUp.notify_one();
+    }
+
+    /// Runs one task: from the back of own deque or stolen from the others.
+    bool tryRun(size_t own) {
+        Task task;
+        for (size_t i = 0; i < queues.size() && !task; ++i) {
+            WorkQueue & queue = queues[(own + i) % queues.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.tasks.empty())
+                continue;
+            if (i == 0) {
+                task.swap(queue.tasks.back());
+                queue.tasks.pop_back();
+            } else {
+                task.swap(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+        }
+        if (!task)
+            return false;
+        --pending;
+        task();
+        return true;
+    }
+
+    void work(size_t queue, Task threadInit) {
+        if (threadInit)
+            threadInit();
+        WorkerId & id = currentWorker();
+        id.pool = this;
+        id.queue = queue;
+        while (true) {
+            if (tryRun(queue))
+                continue;
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            wakeUp.wait(lock, [this]() { return done || pending > 0; });
+            if (done && pending <= 0)
+                return;
+        }
+    }
+
+    std::vector<WorkQueue> queues; // 0 is shared by non-worker threads
+
+    std::vector<std::thread> threads;
+
+    std::atomic<long> pending; // may be negative for a moment
+
+    std::mutex sleepMutex;
+
+    std::condition_variable wakeUp;
+
+    bool done;
+};
+
+} // namespace mv_poly
+
+#endif /* EXECUTOR_HPP_ */
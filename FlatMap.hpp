@@ -0,0 +1,167 @@
+/**
+ * @file FlatMap.hpp
+ *
+ * Sorted-vector associative container with the subset of std::map
+ * interface used for the state of BMS-algorithm (F, G and auxiliary
+ * per-polynomial data).
+ */
+
+#ifndef FLATMAP_HPP_
+#define FLATMAP_HPP_
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace mv_poly {
+
+/**
+ * \class FlatMap
+ * Map stored as a vector of (key, value) pairs sorted by key. Elements are
+ * contiguous, so traversal is cache-friendly and clear() keeps the storage
+ * for reuse: a container that is cleared and refilled at every step
+ * allocates only when it grows (assignKeys keeps the values too, for the
+ * storage they own). Values are moved on insertion in the
+ * middle, so it suits maps of dozens of elements with cheaply movable
+ * values (as polynomials are).
+ *
+ * Unlike std::map, iterators and references are invalidated by insertion.
+ * Elements inserted in increasing order of keys (cf. \c push_back) cost
+ * O(1) amortized.
+ *
+ * @param Key Key type.
+ * @param T Mapped type.
+ * @param Compare Strict weak order of keys.
+ */
+template<typename Key, typename T, typename Compare = std::less<Key> >
+class FlatMap {
+public:
+    typedef Key key_type;
+
+    typedef T mapped_type;
+
+    /// Key isn't const (unlike std::map) for vector elements to be assignable.
+    typedef std::pair<Key, T> value_type;
+
+    typedef std::vector<value_type> StorageT;
+
+    typedef typename StorageT::iterator iterator;
+
+    typedef typename StorageT::const_iterator const_iterator;
+
+    typedef typename StorageT::size_type size_type;
+
+    iterator begin() { return data.begin(); }
+
+    iterator end() { return data.end(); }
+
+    const_iterator begin() const { return data.begin(); }
+
+    const_iterator end() const { return data.end(); }
+
+    size_type size() const { return data.size(); }
+
+    bool empty() const { return data.empty(); }
+
+    /// Removes all the elements keeping the storage allocated.
+    void clear() { data.clear(); }
+
+    void reserve(size_type n) { data.reserve(n); }
+
+    void swap(FlatMap & other) { data.swap(other.data); }
+
+    /**
+     * Makes \c [first, last) (increasing and unique) the keys of the map
+     * keeping the values in place: the values of the first elements stay
+     * with their storage to be overwritten, the missing ones are
+     * default-constructed and the extra ones are removed.
+     */
+    template<typename KeyIt>
+    void assignKeys(KeyIt first, KeyIt last) {
+        size_type n = 0;
+        for (; first != last; ++first, ++n)
+            if (n < data.size())
+                data[n].first = *first;
+            else
+                data.push_back(value_type(*first, T()));
+        data.erase(data.begin() + n, data.end());
+    }
+
+    iterator lower_bound(Key const & key) {
+        return std::lower_bound(data.begin(), data.end(), key, KeyLess());
+    }
+
+    const_iterator lower_bound(Key const & key) const {
+        return std::lower_bound(data.begin(), data.end(), key, KeyLess());
+    }
+
+    iterator find(Key const & key) {
+        iterator it = lower_bound(key);
+        return it != data.end() && !Compare()(key, it->first) ? it : data.end();
+    }
+
+    const_iterator find(Key const & key) const {
+        const_iterator it = lower_bound(key);
+        return it != data.end() && !Compare()(key, it->first) ? it : data.end();
+    }
+
+    size_type count(Key const & key) const {
+        return find(key) != end();
+    }
+
+    /// Inserts the element if the key is absent (cf. std::map::insert).
+    std::pair<iterator, bool> insert(value_type const & v) {
+        iterator it = lower_bound(v.first);
+        if (it != data.end() && !Compare()(v.first, it->first))
+            return std::make_pair(it, false);
+        return std::make_pair(data.insert(it, v), true);
+    }
+
+    std::pair<iterator, bool> insert(value_type && v) {
+        iterator it = lower_bound(v.first);
+        if (it != data.end() && !Compare()(v.first, it->first))
+            return std::make_pair(it, false);
+        return std::make_pair(data.insert(it, std::move(v)), true);
+    }
+
+    T & operator[](Key const & key) {
+        iterator it = lower_bound(key);
+        if (it == data.end() || Compare()(key, it->first))
+            it = data.insert(it, value_type(key, T()));
+        return it->second;
+    }
+
+    /**
+     * Appends the element with the key greater than all the present ones
+     * (falls back to \c insert otherwise).
+     */
+    T & push_back(Key const & key, T && value) {
+        if (data.empty() || Compare()(data.back().first, key)) {
+            data.push_back(value_type(key, std::move(value)));
+            return data.back().second;
+        }
+        return insert(value_type(key, std::move(value))).first->second;
+    }
+
+    friend bool operator==(FlatMap const & lhs, FlatMap const & rhs) {
+        return lhs.data == rhs.data;
+    }
+
+    friend bool operator!=(FlatMap const & lhs, FlatMap const & rhs) {
+        return !(lhs == rhs);
+    }
+
+private:
+    struct KeyLess {
+        bool operator()(value_type const & v, Key const & key) const {
+            return Compare()(v.first, key);
+        }
+    };
+
+    StorageT data;
+};
+
+} // namespace mv_poly
+
+#endif /* FLATMAP_HPP_ */
@@ -0,0 +1,101 @@
+/**
+ * @file MappedFile.hpp
+ *
+ * Read-only view of a whole file as a range of bytes, for the parsers
+ * working on buffers (cf. TextParser.hpp, PolyArchive.hpp).
+ */
+
+#ifndef MAPPEDFILE_HPP_
+#define MAPPEDFILE_HPP_
+
+#include <stdexcept>
+#include <string>
+
+#include <cstddef>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#include <iterator>
+#endif
+
+namespace mv_poly {
+
+/**
+ * \class MappedFile
+ * Read-only view of a file: mapped to memory where mmap is available,
+ * read into memory otherwise. Throws std::runtime_error if the file can't
+ * be read.
+ */
+class MappedFile {
+public:
+    explicit MappedFile(std::string const & path) : data(0), size(0) {
+#if defined(__unix__) || defined(__APPLE__)
+        int const fd = ::open(path.c_str(), O_RDONLY);
+        struct stat st;
+        if (fd < 0 || ::fstat(fd, &st) != 0) {
+            if (fd >= 0)
+                ::close(fd);
+            throw std::runtime_error("can't open " + path);
+        }
+        size = st.st_size;
+        if (size > 0) {
+            void * const p = ::mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("can't map " + path);
+            }
+            data = static_cast<char const *>(p);
+        }
+        ::close(fd);
+#else
+        std::ifstream is(path.c_str(), std::ios::binary);
+        if (!is)
+            throw std::runtime_error("can't open " + path);
+        contents.assign(std::istreambuf_iterator<char>(is),
+                std::istreambuf_iterator<char>());
+        data = contents.data();
+        size = contents.size();
+#endif
+    }
+
+    ~MappedFile() {
+#if defined(__unix__) || defined(__APPLE__)
+        if (size > 0)
+            ::munmap(const_cast<char *>(data), size);
+#endif
+    }
+
+    char const * begin() const {
+        return data;
+    }
+
+    char const * end() const {
+        return data + size;
+    }
+
+    size_t getSize() const {
+        return size;
+    }
+
+private:
+    MappedFile(MappedFile const &);
+
+    MappedFile & operator=(MappedFile const &);
+
+    char const * data;
+
+    size_t size;
+
+#if !defined(__unix__) && !defined(__APPLE__)
+    std::string contents;
+#endif
+};
+
+} // namespace mv_poly
+
+#endif /* MAPPEDFILE_HPP_ */
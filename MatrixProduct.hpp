@@ -0,0 +1,90 @@
+/**
+ * @file MatrixProduct.hpp
+ *
+ * Cache-blocked product of dense row-major matrices over a field, used to
+ * compute the syndromes of a batch of words at once (cf.
+ * BMSDecoding::computeSyndromes).
+ */
+
+#ifndef MATRIXPRODUCT_HPP_
+#define MATRIXPRODUCT_HPP_
+
+#include <algorithm>
+#include <vector>
+
+#include <cstddef>
+
+#include "CoefficientTraits.hpp"
+
+namespace mv_poly {
+
+/**
+ * Block sizes of multiplyBlocked: a block of \c rows rows of A times a
+ * block of \c inner rows of B is accumulated into a block of \c rows by
+ * \c cols of C. The defaults keep a block of B and the rows of C it
+ * updates in L2 cache for element types of a few machine words.
+ */
+struct MatrixBlocking {
+    size_t rows;
+
+    size_t inner;
+
+    size_t cols;
+
+    MatrixBlocking(size_t rows_ = 32, size_t inner_ = 128, size_t cols_ = 64) :
+        rows(rows_), inner(inner_), cols(cols_) {}
+};
+
+/**
+ * C += A B for row-major A (m x k), B (k x n) and C (m x n).
+ *
+ * The innermost loop runs along a row of B and of C with one element of A
+ * fixed, so it has no dependencies between iterations and is vectorized by
+ * the compiler for arithmetic element types. Zero elements of A aren't
+ * skipped: a monomial vanishes at a curve point only if a coordinate of
+ * the point is zero, so few entries of the parity-check matrices of curve
+ * codes are zero, and the test would cost more than it saves.
+ */
+template<typename Field>
+void multiplyBlocked(
+        size_t m, size_t k, size_t n,
+        Field const * a,
+        Field const * b,
+        Field * c,
+        MatrixBlocking const & blocking = MatrixBlocking()) {
+    for (size_t j0 = 0; j0 < n; j0 += blocking.cols) {
+        size_t const j1 = std::min(n, j0 + blocking.cols);
+        for (size_t p0 = 0; p0 < k; p0 += blocking.inner) {
+            size_t const p1 = std::min(k, p0 + blocking.inner);
+            for (size_t i0 = 0; i0 < m; i0 += blocking.rows) {
+                size_t const i1 = std::min(m, i0 + blocking.rows);
+                for (size_t i = i0; i < i1; ++i) {
+                    Field * const cRow = c + i * n;
+                    for (size_t p = p0; p < p1; ++p) {
+                        Field const & x = a[i * k + p];
+                        Field const * const bRow = b + p * n;
+                        for (size_t j = j0; j < j1; ++j)
+                            cRow[j] += x * bRow[j];
+                    }
+                }
+            }
+        }
+    }
+}
+
+/// A B for row-major A (m x k) and B (k x n), cf. multiplyBlocked.
+template<typename Field>
+std::vector<Field> multiplyBlocked(
+        size_t m, size_t k, size_t n,
+        std::vector<Field> const & a,
+        std::vector<Field> const & b,
+        MatrixBlocking const & blocking = MatrixBlocking()) {
+    std::vector<Field> result(m * n, CoefficientTraits<Field>::addId());
+    if (m && k && n)
+        multiplyBlocked(m, k, n, a.data(), b.data(), result.data(), blocking);
+    return result;
+}
+
+} // namespace mv_poly
+
+#endif /* MATRIXPRODUCT_HPP_ */
@@ -8,7 +8,6 @@
 #ifndef NTLPOLYNOMIALS_HPP_
 #define NTLPOLYNOMIALS_HPP_
 
-#include <map>
 #include <string>
 
 #include <NTL/GF2.h>
@@ -47,6 +46,9 @@ std::string coefToString(CoefT const & cf, typename boost::enable_if<
  * Effector (cf. Eckel, TIC++ vol. 2, ch. 4) that takes a polynomial ‘p’
  * and a field primitive element ‘a’ to print ‘p’ in a “pretty” form:
  * a^k x^(m, n) + a^k' x^(m', n') + …
+ *
+ * The terms come from orderedTerms: the merge allocates O(rows) once per
+ * printed polynomial, and no map of the terms is built.
  */
 template<template <typename> class OrderPolicy, typename T>
 class PowerPolyPrinter {
@@ -55,37 +57,28 @@ class PowerPolyPrinter {
 
     typedef Point<Polynomial<T>::VAR_CNT, OrderPolicy> PointT;
 
-    typedef std::map<PointT, CoefT> PointCoefMap;
-
-    PointCoefMap data;
+    Polynomial<T> const & poly;
 
     void print(std::ostream & os) const {
-        if (data.empty())
-            return;
-        for(typename PointCoefMap::const_iterator it = data.begin();
-                it != --data.end(); ++it) {
-            typename PointCoefMap::value_type const & pt_cf = *it;
-            if (pt_cf.second != CoefT::zero()) {
-                const std::string strCoef = coefToString(pt_cf.second);
-                if (pt_cf.first == PointT()) {
-                    os << strCoef + " + ";
-                } else
-                    os << (pt_cf.second == FieldElemTraits<CoefT>::multId()
-                                ? "" : strCoef + " ")
-                            << "X^" << pt_cf.first << " + ";
-            }
+        bool first = true;
+        for (auto const & term : orderedTerms<OrderPolicy>(poly)) {
+            if (!first)
+                os << " + ";
+            first = false;
+            CoefT const & cf = term.getCoef();
+            if (term.getPoint() == PointT())
+                os << coefToString(cf);
+            else
+                os << (cf == FieldElemTraits<CoefT>::multId()
+                            ? "" : coefToString(cf) + " ")
+                        << "X^" << term.getPoint();
         }
-        typename PointCoefMap::value_type const & pt_cf = *(--data.end());
-        const std::string strCoef = coefToString(pt_cf.second);
-        os << (pt_cf.second == FieldElemTraits<CoefT>::multId()
-                ? "" : strCoef + " ") << "X^" << pt_cf.first;
     }
 
 public:
 
-    PowerPolyPrinter(Polynomial<T> const & p) {
-        data = polyToDegCoefMap<OrderPolicy>(p);
-    }
+    /// Refers to \c p, which has to outlive the printer.
+    PowerPolyPrinter(Polynomial<T> const & p) : poly(p) {}
 
     friend
     std::ostream & operator<<(
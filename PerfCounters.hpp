@@ -0,0 +1,332 @@
+/**
+ * @file PerfCounters.hpp
+ *
+ * Per-step performance counters of BMS-algorithm and their JSON dump.
+ *
+ * Counting costs time on every step (some counters walk the polynomials),
+ * so the counters are compiled in only if \c MV_POLY_PERF_COUNTERS is
+ * defined to 1:
+ * \code
+ * g++ -DMV_POLY_PERF_COUNTERS=1 ...   // count
+ * \endcode
+ * Otherwise the code wrapped by \c MV_POLY_COUNT disappears and the
+ * classes using the counters don't have them as members. Even then only
+ * the totals are kept unless the counters of every step are asked for
+ * (cf. BmsaPerfCounters::setStepsRecorded).
+ */
+
+#ifndef PERFCOUNTERS_HPP_
+#define PERFCOUNTERS_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#ifndef MV_POLY_PERF_COUNTERS
+#define MV_POLY_PERF_COUNTERS 0
+#endif
+
+#if MV_POLY_PERF_COUNTERS
+#define MV_POLY_COUNT(...) __VA_ARGS__
+#else
+#define MV_POLY_COUNT(...)
+#endif
+
+namespace mv_poly {
+
+/**
+ * Seconds summed up by several threads without locking (a compare and
+ * swap loop, as std::atomic<double> has no fetch_add).
+ */
+class AtomicSeconds {
+public:
+    AtomicSeconds() : value(0) {}
+
+    AtomicSeconds & operator=(double v) {
+        value.store(v, std::memory_order_relaxed);
+        return *this;
+    }
+
+    AtomicSeconds & operator+=(double v) {
+        double old = value.load(std::memory_order_relaxed);
+        while (!value.compare_exchange_weak(old, old + v, std::memory_order_relaxed))
+            ;
+        return *this;
+    }
+
+    operator double() const {
+        return value.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<double> value;
+};
+
+/**
+ * Counters of one step of BMS-algorithm or sums of them over the steps;
+ * cf. BmsaCounters for one thread and SharedBmsaCounters for sums merged
+ * by several threads.
+ * @param Count Type of the counts.
+ * @param Seconds Type of the times.
+ */
+template<typename Count, typename Seconds>
+struct BasicBmsaCounters {
+    /// Discrepancies computed (convolutions with the sequence).
+    Count convolutions;
+
+    /// Nonzero terms of f summed up in the convolutions.
+    Count convolutionTerms;
+
+    /// Support caching: convolutions over a support just extracted from f.
+    Count newSupportUses;
+
+    /// Support caching: convolutions over a support reused from the
+    /// previous steps (f is unchanged up to a monomial factor); the
+    /// convolution itself is still summed up in full.
+    Count reusedSupportUses;
+
+    /// Support caching: supports carried over to new F by shifting.
+    Count shiftedSupports;
+
+    /// Support caching: supports extracted anew after Berlekamp update.
+    Count rebuiltSupports;
+
+    Count nonzeroDiscrepancies;
+
+    /// Polynomials of new F obtained by Berlekamp formula.
+    Count berlekampUpdates;
+
+    /// Polynomials of new F obtained by deg bump.
+    Count degBumps;
+
+    /// Size of the delta-set (maximal points) after the step.
+    Count deltaSize;
+
+    /// Size of the sigma-set (size of new F).
+    Count sigmaSize;
+
+    /// Multiplications of field elements (in convolutions and scaling of
+    /// polynomials by discrepancies).
+    Count fieldMults;
+
+    Count fieldInversions;
+
+    /// Polynomials and cached supports built (each allocates its storage).
+    Count allocations;
+
+    /// Wall time (seconds) spent for discrepancies.
+    Seconds discrepancyTime;
+
+    /// Wall time (seconds) spent for forming new F.
+    Seconds newFTime;
+
+    /// Wall time (seconds) spent for forming new G.
+    Seconds newGTime;
+
+    BasicBmsaCounters() {
+        clear();
+    }
+
+    /// Sums of \c other (of any counter types).
+    template<typename C, typename S>
+    explicit BasicBmsaCounters(BasicBmsaCounters<C, S> const & other) {
+        clear();
+        *this += other;
+    }
+
+    void clear() {
+        convolutions = 0;
+        convolutionTerms = 0;
+        newSupportUses = 0;
+        reusedSupportUses = 0;
+        shiftedSupports = 0;
+        rebuiltSupports = 0;
+        nonzeroDiscrepancies = 0;
+        berlekampUpdates = 0;
+        degBumps = 0;
+        deltaSize = 0;
+        sigmaSize = 0;
+        fieldMults = 0;
+        fieldInversions = 0;
+        allocations = 0;
+        discrepancyTime = 0;
+        newFTime = 0;
+        newGTime = 0;
+    }
+
+    /// Sums the counters (set sizes are the ones of the latest step).
+    template<typename C, typename S>
+    BasicBmsaCounters & operator+=(BasicBmsaCounters<C, S> const & other) {
+        convolutions += other.convolutions;
+        convolutionTerms += other.convolutionTerms;
+        newSupportUses += other.newSupportUses;
+        reusedSupportUses += other.reusedSupportUses;
+        shiftedSupports += other.shiftedSupports;
+        rebuiltSupports += other.rebuiltSupports;
+        nonzeroDiscrepancies += other.nonzeroDiscrepancies;
+        berlekampUpdates += other.berlekampUpdates;
+        degBumps += other.degBumps;
+        deltaSize = other.deltaSize;
+        sigmaSize = other.sigmaSize;
+        fieldMults += other.fieldMults;
+        fieldInversions += other.fieldInversions;
+        allocations += other.allocations;
+        discrepancyTime += other.discrepancyTime;
+        newFTime += other.newFTime;
+        newGTime += other.newGTime;
+        return *this;
+    }
+
+    /**
+     * JSON object with the counters as its fields (of a BmsaCounters, to
+     * write shared ones take a copy first).
+     */
+    void writeJson(std::ostream & os) const {
+        os << "{\"convolutions\": " << convolutions
+           << ", \"convolutionTerms\": " << convolutionTerms
+           << ", \"newSupportUses\": " << newSupportUses
+           << ", \"reusedSupportUses\": " << reusedSupportUses
+           << ", \"shiftedSupports\": " << shiftedSupports
+           << ", \"rebuiltSupports\": " << rebuiltSupports
+           << ", \"nonzeroDiscrepancies\": " << nonzeroDiscrepancies
+           << ", \"berlekampUpdates\": " << berlekampUpdates
+           << ", \"degBumps\": " << degBumps
+           << ", \"deltaSize\": " << deltaSize
+           << ", \"sigmaSize\": " << sigmaSize
+           << ", \"fieldMults\": " << fieldMults
+           << ", \"fieldInversions\": " << fieldInversions
+           << ", \"allocations\": " << allocations
+           << ", \"discrepancyTime\": " << discrepancyTime
+           << ", \"newFTime\": " << newFTime
+           << ", \"newGTime\": " << newGTime
+           << "}";
+    }
+};
+
+/// Counters of one thread.
+typedef BasicBmsaCounters<unsigned long, double> BmsaCounters;
+
+/// Sums of counters added by several threads without locking.
+typedef BasicBmsaCounters<std::atomic<unsigned long>, AtomicSeconds> SharedBmsaCounters;
+
+/**
+ * Adds wall time from its construction to \c stop (or to its destruction)
+ * to the given counter (in seconds).
+ */
+class PhaseTimer {
+public:
+    explicit PhaseTimer(double & counter_) :
+        counter(counter_), start(std::chrono::steady_clock::now()),
+        running(true) {}
+
+    ~PhaseTimer() {
+        stop();
+    }
+
+    void stop() {
+        if (!running)
+            return;
+        running = false;
+        counter += std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - start).count();
+    }
+
+private:
+    PhaseTimer(PhaseTimer const &);
+
+    PhaseTimer & operator=(PhaseTimer const &);
+
+    double & counter;
+
+    std::chrono::steady_clock::time_point start;
+
+    bool running;
+};
+
+/**
+ * Counters of BMS-algorithm summed over the steps and, if recorded (cf.
+ * setStepsRecorded), the counters of every step.
+ * @param PointT Type of points the steps are made for.
+ */
+template<typename PointT>
+class BmsaPerfCounters {
+public:
+    typedef std::vector< std::pair<PointT, BmsaCounters> > StepCollection;
+
+    BmsaPerfCounters() : stepsRecorded(false) {}
+
+    /// Starts counting for the step at \c k.
+    void beginStep(PointT const & k) {
+        step = std::make_pair(k, BmsaCounters());
+    }
+
+    /// Counters of the current step.
+    BmsaCounters & current() {
+        return step.second;
+    }
+
+    /// Adds the counters of the current step to the totals (and the steps).
+    void endStep() {
+        total += step.second;
+        if (stepsRecorded)
+            steps.push_back(step);
+    }
+
+    /**
+     * Whether the counters of every step are kept (off by default as they
+     * grow with the steps), only the totals otherwise.
+     */
+    void setStepsRecorded(bool recorded) {
+        stepsRecorded = recorded;
+    }
+
+    bool areStepsRecorded() const { return stepsRecorded; }
+
+    /// Counters of the steps if recorded, empty otherwise.
+    StepCollection const & getSteps() const { return steps; }
+
+    BmsaCounters const & getTotal() const { return total; }
+
+    void clear() {
+        steps.clear();
+        total = BmsaCounters();
+    }
+
+    /**
+     * JSON object: <tt>{"total": {...}, "steps": [{"k": [...], ...}, ...]}</tt>
+     * (cf. BmsaCounters::writeJson for the fields), without \c steps if
+     * they aren't recorded.
+     */
+    void writeJson(std::ostream & os) const {
+        os << "{\"total\": ";
+        total.writeJson(os);
+        if (stepsRecorded) {
+            os << ", \"steps\": [";
+            for (size_t i = 0; i < steps.size(); ++i) {
+                os << (i ? ", " : "") << "{\"k\": [";
+                for (int j = 0; j < PointT::DIM; ++j)
+                    os << (j ? ", " : "") << steps[i].first[j];
+                os << "], \"counters\": ";
+                steps[i].second.writeJson(os);
+                os << "}";
+            }
+            os << "]";
+        }
+        os << "}";
+    }
+
+private:
+    bool stepsRecorded;
+
+    std::pair<PointT, BmsaCounters> step;
+
+    StepCollection steps;
+
+    BmsaCounters total;
+};
+
+} // namespace mv_poly
+
+#endif /* PERFCOUNTERS_HPP_ */
@@ -0,0 +1,468 @@
+/**
+ * @file Pipeline.hpp
+ *
+ * Stages running in their own threads and connected by bounded lock-free
+ * queues, used to decode a stream of words on all the cores (cf.
+ * BMSDecodingPipeline).
+ */
+
+#ifndef PIPELINE_HPP_
+#define PIPELINE_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+
+namespace mv_poly {
+
+/**
+ * \class BoundedQueue
+ * Bounded multi-producer multi-consumer queue on a ring of cells with
+ * sequence numbers (D. Vyukov's algorithm): a push or a pop is one CAS on
+ * the position and no lock is taken. With one producer and one consumer
+ * the CAS never fails, so the same queue serves as an SPSC one.
+ *
+ * \c push waits while the queue is full, which is what gives backpressure
+ * to the producers; \c pop waits while it is empty. After \c close
+ * (called once all the producers are done) \c pop drains the queue and
+ * then fails.
+ * @param T Default-constructible, movable type of elements.
+ */
+template<typename T>
+class BoundedQueue {
+public:
+    /// The capacity is rounded up to a power of two.
+    explicit BoundedQueue(size_t capacity) :
+            mask(roundUp(capacity) - 1),
+            cells(new Cell[mask + 1]),
+            enqueuePos(0), dequeuePos(0), closed(false) {
+        for (size_t i = 0; i <= mask; ++i)
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    size_t capacity() const {
+        return mask + 1;
+    }
+
+    /// Pushes \c value unless the queue is full.
+    bool tryPush(T & value) {
+        size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        while (true) {
+            Cell & cell = cells[pos & mask];
+            size_t const seq = cell.sequence.load(std::memory_order_acquire);
+            long const diff = long(seq) - long(pos);
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1,
+                        std::memory_order_relaxed)) {
+                    cell.value = std::move(value);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// Pops to \c value unless the queue is empty.
+    bool tryPop(T & value) {
+        size_t pos = dequeuePos.load(std::memory_order_relaxed);
+        while (true) {
+            Cell & cell = cells[pos & mask];
+            size_t const seq = cell.sequence.load(std::memory_order_acquire);
+            long const diff = long(seq) - long(pos + 1);
+            if (diff == 0) {
+                if (dequeuePos.compare_exchange_weak(pos, pos + 1,
+                        std::memory_order_relaxed)) {
+                    value = std::move(cell.value);
+                    cell.sequence.store(pos + mask + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// Waits for room and pushes \c value, fails if the queue is closed.
+    bool push(T value) {
+        Backoff backoff;
+        while (!tryPush(value)) {
+            if (closed.load(std::memory_order_acquire))
+                return false;
+            backoff.pause();
+        }
+        return true;
+    }
+
+    /// Waits for an element, fails once the queue is closed and empty.
+    bool pop(T & value) {
+        Backoff backoff;
+        while (!tryPop(value)) {
+            if (closed.load(std::memory_order_acquire))
+                return tryPop(value);
+            backoff.pause();
+        }
+        return true;
+    }
+
+    void close() {
+        closed.store(true, std::memory_order_release);
+    }
+
+    bool isClosed() const {
+        return closed.load(std::memory_order_acquire);
+    }
+
+private:
+    BoundedQueue(BoundedQueue const &);
+
+    BoundedQueue & operator=(BoundedQueue const &);
+
+    struct Cell {
+        std::atomic<size_t> sequence;
+
+        T value;
+    };
+
+    /// Spins for a while, then yields, then sleeps: waits are short under
+    /// load and don't burn a core when a stage is idle.
+    struct Backoff {
+        Backoff() : count(0) {}
+
+        void pause() {
+            if (++count < 64)
+                return;
+            if (count < 256)
+                std::this_thread::yield();
+            else
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+
+        unsigned count;
+    };
+
+    static size_t roundUp(size_t n) {
+        size_t result = 2;
+        while (result < n)
+            result *= 2;
+        return result;
+    }
+
+    size_t const mask;
+
+    std::unique_ptr<Cell[]> cells;
+
+    // padding keeps the positions on different cache lines
+    char padding0[64];
+
+    std::atomic<size_t> enqueuePos;
+
+    char padding1[64];
+
+    std::atomic<size_t> dequeuePos;
+
+    char padding2[64];
+
+    std::atomic<bool> closed;
+};
+
+/**
+ * \class LatencyHistogram
+ * Histogram of durations with a bucket per power of two nanoseconds,
+ * filled by any number of threads at once.
+ */
+class LatencyHistogram {
+public:
+    enum { BUCKETS = 48 };
+
+    LatencyHistogram() : count(0), total(0), max(0) {
+        for (int i = 0; i < BUCKETS; ++i)
+            buckets[i].store(0, std::memory_order_relaxed);
+    }
+
+    void record(std::chrono::steady_clock::duration d) {
+        unsigned long const ns = std::max<long long>(0,
+                std::chrono::duration_cast<std::chrono::nanoseconds>(d).count());
+        int b = 0;
+        while (b + 1 < BUCKETS && (1ul << b) <= ns)
+            ++b;
+        buckets[b].fetch_add(1, std::memory_order_relaxed);
+        count.fetch_add(1, std::memory_order_relaxed);
+        total.fetch_add(ns, std::memory_order_relaxed);
+        unsigned long m = max.load(std::memory_order_relaxed);
+        while (m < ns && !max.compare_exchange_weak(m, ns,
+                std::memory_order_relaxed))
+            ;
+    }
+
+    unsigned long getCount() const {
+        return count.load(std::memory_order_relaxed);
+    }
+
+    unsigned long getMax() const {
+        return max.load(std::memory_order_relaxed);
+    }
+
+    /// Upper bound (ns) of the bucket the \c q quantile (0 < q <= 1) is in.
+    unsigned long quantile(double q) const {
+        unsigned long const n = getCount();
+        unsigned long seen = 0;
+        for (int b = 0; b < BUCKETS; ++b) {
+            seen += buckets[b].load(std::memory_order_relaxed);
+            if (n > 0 && seen >= q * n)
+                return std::min(1ul << b, getMax());
+        }
+        return getMax();
+    }
+
+    /// Writes count, mean, p50, p90, p99, max (ns) and the non-empty buckets.
+    void writeJson(std::ostream & os) const {
+        unsigned long const n = getCount();
+        os << "{\"count\": " << n
+           << ", \"meanNs\": " << (n ? total.load(std::memory_order_relaxed) / n : 0)
+           << ", \"p50Ns\": " << quantile(0.5)
+           << ", \"p90Ns\": " << quantile(0.9)
+           << ", \"p99Ns\": " << quantile(0.99)
+           << ", \"maxNs\": " << getMax()
+           << ", \"buckets\": {";
+        bool first = true;
+        for (int b = 0; b < BUCKETS; ++b) {
+            unsigned long const c = buckets[b].load(std::memory_order_relaxed);
+            if (c == 0)
+                continue;
+            os << (first ? "" : ", ") << "\"" << (1ul << b) << "\": " << c;
+            first = false;
+        }
+        os << "}}";
+    }
+
+private:
+    LatencyHistogram(LatencyHistogram const &);
+
+    LatencyHistogram & operator=(LatencyHistogram const &);
+
+    std::atomic<unsigned long> buckets[BUCKETS];
+
+    std::atomic<unsigned long> count;
+
+    std::atomic<unsigned long> total;
+
+    std::atomic<unsigned long> max;
+};
+
+/**
+ * \class Pipeline
+ * Chain of stages, every one run by its own threads on the jobs coming
+ * from the queue before it and passing them to the queue after it. The
+ * queues are bounded, so a slow stage holds back the ones before it and
+ * \c push blocks instead of letting the jobs pile up.
+ *
+ * A stage with several threads may pass the jobs on in another order, so
+ * the jobs should carry whatever identifies them. The time of every stage
+ * per job and the time from \c push to \c pop are kept in histograms.
+ *
+ * A job a stage throws on skips the stages after it and the exception is
+ * rethrown by the \c pop of that job, so every pushed job is popped once
+ * either way.
+ *
+ * NTL keeps moduli per thread, so the threads of the stages should
+ * restore the context of the creating thread (cf. WorkStealingPool).
+ * @param Job Default-constructible, movable type of jobs.
+ */
+template<typename Job>
+class Pipeline {
+public:
+    typedef std::function<void (Job &)> Stage;
+
+    typedef std::function<void ()> ThreadInit;
+
+    /**
+     * @param capacity_ Capacity of every queue.
+     * @param threadInit_ Called by every thread of the stages first.
+     */
+    explicit Pipeline(size_t capacity_ = 64,
+            ThreadInit const & threadInit_ = ThreadInit()) :
+                capacity(capacity_), threadInit(threadInit_), started(false) {}
+
+    /// Stops the stages, the jobs not popped yet are dropped.
+    ~Pipeline() {
+        for (size_t s = 0; s < queues.size(); ++s)
+            queues[s]->close();
+        for (size_t i = 0; i < threads.size(); ++i)
+            threads[i].join();
+    }
+
+    /// Appends a stage run by \c threadCnt threads (before \c start).
+    void addStage(std::string const & name, Stage const & stage,
+            unsigned threadCnt = 1) {
+        stages.push_back(std::unique_ptr<StageInfo>(
+                new StageInfo(name, stage, std::max(1u, threadCnt))));
+    }
+
+    /// Makes the queues and starts the threads of the stages.
+    void start() {
+        started = true;
+        for (size_t s = 0; s <= stages.size(); ++s)
+            queues.push_back(std::unique_ptr<QueueT>(new QueueT(capacity)));
+        for (size_t s = 0; s < stages.size(); ++s) {
+            stages[s]->running = stages[s]->threadCnt;
+            for (unsigned t = 0; t < stages[s]->threadCnt; ++t)
+                threads.push_back(std::thread(&Pipeline::work, this, s));
+        }
+    }
+
+    /// Passes \c job to the first stage, waiting for room; fails after \c close.
+    bool push(Job job) {
+        Envelope envelope;
+        envelope.job = std::move(job);
+        envelope.pushed = std::chrono::steady_clock::now();
+        return queues.front()->push(std::move(envelope));
+    }
+
+    /**
+     * Takes the next job the last stage is done with, waiting for it. Fails
+     * once the pipeline is closed and empty. If a stage has thrown on the
+     * job, \c job is set as the stage left it and the exception is
+     * rethrown.
+     */
+    bool pop(Job & job) {
+        Envelope envelope;
+        if (!queues.back()->pop(envelope))
+            return false;
+        latency.record(std::chrono::steady_clock::now() - envelope.pushed);
+        job = std::move(envelope.job);
+        if (envelope.error)
+            std::rethrow_exception(envelope.error);
+        return true;
+    }
+
+    /// No more jobs: the stages finish the ones they have and stop.
+    void close() {
+        if (started)
+            queues.front()->close();
+    }
+
+    size_t getStageCnt() const {
+        return stages.size();
+    }
+
+    std::string const & getStageName(size_t s) const {
+        return stages[s]->name;
+    }
+
+    /// Time of the \c s-th stage per job.
+    LatencyHistogram const & getStageLatency(size_t s) const {
+        return stages[s]->latency;
+    }
+
+    /// Time from \c push to \c pop per job.
+    LatencyHistogram const & getLatency() const {
+        return latency;
+    }
+
+    /// Writes the histograms: the whole pipeline and every stage by name.
+    void writeJson(std::ostream & os) const {
+        os << "{\"latency\": ";
+        latency.writeJson(os);
+        os << ", \"stages\": [";
+        for (size_t s = 0; s < stages.size(); ++s) {
+            os << (s ? ", " : "") << "{\"name\": \"" << stages[s]->name
+               << "\", \"threads\": " << stages[s]->threadCnt << ", \"latency\": ";
+            stages[s]->latency.writeJson(os);
+            os << "}";
+        }
+        os << "]}";
+    }
+
+private:
+    Pipeline(Pipeline const &);
+
+    Pipeline & operator=(Pipeline const &);
+
+    struct Envelope {
+        Job job;
+
+        std::chrono::steady_clock::time_point pushed;
+
+        /// Thrown by a stage on the job: the later stages pass it on.
+        std::exception_ptr error;
+    };
+
+    typedef BoundedQueue<Envelope> QueueT;
+
+    struct StageInfo {
+        StageInfo(std::string const & name_, Stage const & stage_,
+                unsigned threadCnt_) :
+                    name(name_), stage(stage_), threadCnt(threadCnt_),
+                    running(0) {}
+
+        std::string const name;
+
+        Stage const stage;
+
+        unsigned const threadCnt;
+
+        /// Threads of the stage still running: the last one closes the
+        /// queue after the stage.
+        std::atomic<unsigned> running;
+
+        LatencyHistogram latency;
+    };
+
+    void work(size_t s) {
+        if (threadInit)
+            threadInit();
+        StageInfo & stage = *stages[s];
+        QueueT & in = *queues[s];
+        QueueT & out = *queues[s + 1];
+        Envelope envelope;
+        while (in.pop(envelope)) {
+            if (!envelope.error) {
+                std::chrono::steady_clock::time_point const start =
+                        std::chrono::steady_clock::now();
+                try {
+                    stage.stage(envelope.job);
+                    stage.latency.record(std::chrono::steady_clock::now() - start);
+                } catch (...) {
+                    envelope.error = std::current_exception();
+                }
+            }
+            out.push(std::move(envelope));
+        }
+        if (--stage.running == 0)
+            out.close();
+    }
+
+    size_t const capacity;
+
+    ThreadInit const threadInit;
+
+    bool started;
+
+    std::vector< std::unique_ptr<StageInfo> > stages;
+
+    std::vector< std::unique_ptr<QueueT> > queues; // before every stage and the output
+
+    std::vector<std::thread> threads;
+
+    LatencyHistogram latency;
+};
+
+} // namespace mv_poly
+
+#endif /* PIPELINE_HPP_ */
@@ -15,17 +15,19 @@
 #include <initializer_list>
 #include <iostream>
 #include <memory>
+#include <numeric>
 #include <sstream>
 #include <string>
+#include <tuple>
+#include <vector>
 
 #include <cstdio>
 
 #include <functional>
 
-#include <boost/foreach.hpp>
+#include <tr1/functional>
 
-//#include <lpsolve/lp_lib.h>
-#include <glpk.h>
+#include <boost/foreach.hpp>
 
 #include "Utilities.hpp"
 
@@ -46,6 +48,179 @@ bool operator==(
         Point<Dim, OrderPolicy> const & lhs,
         Point<Dim, OrderPolicy> const & rhs);
 
+/**
+ * Coordinate-wise kernels on point implementations (arrays of coordinates).
+ * This general version works for any dimension by means of standard
+ * algorithms; see CoordinateKernels for the dimensions we actually deploy.
+ * @param Dim Dimension of point lattice.
+ */
+template<int Dim>
+struct GenericCoordinateKernels {
+    template<typename Impl>
+    static void add(Impl & lhs, Impl const & rhs) {
+        std::transform(lhs.begin(), lhs.end(), rhs.begin(), lhs.begin(),
+                std::plus<typename Impl::value_type>());
+    }
+
+    template<typename Impl>
+    static void subtract(Impl & lhs, Impl const & rhs) {
+        std::transform(lhs.begin(), lhs.end(), rhs.begin(), lhs.begin(),
+                std::minus<typename Impl::value_type>());
+    }
+
+    /// lhs[i] <= rhs[i] for all i.
+    template<typename Impl>
+    static bool lessEqual(Impl const & lhs, Impl const & rhs) {
+        return std::inner_product(lhs.begin(), lhs.end(), rhs.begin(), true,
+                std::logical_and<bool>(),
+                std::less_equal<typename Impl::value_type>());
+    }
+
+    template<typename Impl>
+    static long weight(Impl const & c) {
+        return std::accumulate(c.begin(), c.end(), 0L);
+    }
+
+    /// Graded antilexicographic “less”.
+    template<typename Impl>
+    static bool gradedAntilexLess(Impl const & lhs, Impl const & rhs) {
+        long lw = weight(lhs);
+        long rw = weight(rhs);
+        return (lw < rw)
+                || (lw == rw
+                        && std::lexicographical_compare(lhs.rbegin(), lhs.rend(),
+                                rhs.rbegin(), rhs.rend()));
+    }
+
+    /// Next point in graded antilexicographic order.
+    template<typename Impl>
+    static void gradedAntilexInc(Impl & data) {
+        using namespace std::tr1::placeholders;
+        typename Impl::iterator
+                itInc = std::find_if(data.begin(), data.end(),
+                    std::tr1::bind(std::logical_not<bool>(),
+                            std::tr1::bind(std::equal_to<int>(), 0, _1))),
+                it(itInc++);
+        if (it == data.end())
+            data[0] = 1;
+        else if (itInc == data.end()) {
+            int a = *it + 1;
+            *it = 0;
+            data[0] = a;
+        } else {
+            ++(*itInc);
+            int a = *it - 1;
+            *it = 0;
+            data[0] = a;
+        }
+    }
+};
+
+/**
+ * Coordinate-wise kernels used by Point and monomial orders. Dimensions 2
+ * (Hermitian codes) and 3 (Sakata's examples) are specialized below with
+ * straight-line code, others fall back to GenericCoordinateKernels.
+ */
+template<int Dim>
+struct CoordinateKernels : GenericCoordinateKernels<Dim> {};
+
+/// \cond
+template<>
+struct CoordinateKernels<2> {
+    template<typename Impl>
+    static void add(Impl & lhs, Impl const & rhs) {
+        lhs[0] += rhs[0];
+        lhs[1] += rhs[1];
+    }
+
+    template<typename Impl>
+    static void subtract(Impl & lhs, Impl const & rhs) {
+        lhs[0] -= rhs[0];
+        lhs[1] -= rhs[1];
+    }
+
+    template<typename Impl>
+    static bool lessEqual(Impl const & lhs, Impl const & rhs) {
+        return lhs[0] <= rhs[0] && lhs[1] <= rhs[1];
+    }
+
+    template<typename Impl>
+    static long weight(Impl const & c) {
+        return c[0] + c[1];
+    }
+
+    template<typename Impl>
+    static bool gradedAntilexLess(Impl const & lhs, Impl const & rhs) {
+        long lw = lhs[0] + lhs[1];
+        long rw = rhs[0] + rhs[1];
+        return lw < rw || (lw == rw && lhs[1] < rhs[1]);
+    }
+
+    template<typename Impl>
+    static void gradedAntilexInc(Impl & data) {
+        if (data[0] != 0) {
+            --data[0];
+            ++data[1];
+        } else {
+            data[0] = data[1] + 1;
+            data[1] = 0;
+        }
+    }
+};
+
+template<>
+struct CoordinateKernels<3> {
+    template<typename Impl>
+    static void add(Impl & lhs, Impl const & rhs) {
+        lhs[0] += rhs[0];
+        lhs[1] += rhs[1];
+        lhs[2] += rhs[2];
+    }
+
+    template<typename Impl>
+    static void subtract(Impl & lhs, Impl const & rhs) {
+        lhs[0] -= rhs[0];
+        lhs[1] -= rhs[1];
+        lhs[2] -= rhs[2];
+    }
+
+    template<typename Impl>
+    static bool lessEqual(Impl const & lhs, Impl const & rhs) {
+        return lhs[0] <= rhs[0] && lhs[1] <= rhs[1] && lhs[2] <= rhs[2];
+    }
+
+    template<typename Impl>
+    static long weight(Impl const & c) {
+        return c[0] + c[1] + c[2];
+    }
+
+    template<typename Impl>
+    static bool gradedAntilexLess(Impl const & lhs, Impl const & rhs) {
+        long lw = lhs[0] + lhs[1] + lhs[2];
+        long rw = rhs[0] + rhs[1] + rhs[2];
+        return lw < rw
+                || (lw == rw
+                        && (lhs[2] < rhs[2]
+                                || (lhs[2] == rhs[2] && lhs[1] < rhs[1])));
+    }
+
+    template<typename Impl>
+    static void gradedAntilexInc(Impl & data) {
+        if (data[0] != 0) {
+            --data[0];
+            ++data[1];
+        } else if (data[1] != 0) {
+            data[0] = data[1] - 1;
+            data[1] = 0;
+            ++data[2];
+        } else {
+            data[0] = data[2] + 1;
+            data[2] = 0;
+        }
+    }
+};
+/// \endcond
+
 /**
  * \class Point
  * Point in N-dimensional integer lattice.
@@ -66,6 +241,9 @@ template<
     ImplType data;
 
 public:
+    /// Dimension of point lattice.
+    static const int DIM = Dim;
+
     /// Creates point (0, 0, ..., 0).
     Point() {
         data.fill(0);
@@ -138,14 +316,12 @@ public:
     { return data.rend(); }
 
     Point& operator+=(Point const & other) {
-        std::transform(this->begin(), this->end(),
-                other.begin(), this->begin(), std::plus<int>());
+        CoordinateKernels<Dim>::add(data, other.data);
         return *this;
     }
 
     Point& operator-=(Point const & other) {
-        std::transform(this->begin(), this->end(),
-                other.begin(), this->begin(), std::minus<int>());
+        CoordinateKernels<Dim>::subtract(data, other.data);
         return *this;
     }
 
@@ -153,6 +329,14 @@ public:
 
     Point operator++(int);
 
+    /**
+     * Checks if the point is enumerated by the monomial order, i.e.\ can be
+     * reached by incrementing Point().
+     */
+    bool isCanonical() const {
+        return MyOrderPolicy::isCanonical(data);
+    }
+
     /**
      * Compaison for equality: two points are equal iff all corresponding coordinates
      * are equal.
@@ -200,111 +384,117 @@ struct GradedAntilexMonomialOrder {
      * \c lhs less then \c rhs, false otherwise (rhs is less or equal to lhs).
      */
     static bool totalLess(PointImplType const & lhs, PointImplType const & rhs) {
-        int lw = weight(lhs);
-        int rw = weight(rhs);
-        return (lw < rw)
-                || (lw == rw
-                        && std::lexicographical_compare(lhs.rbegin(), lhs.rend(),
-                                rhs.rbegin(), rhs.rend()));
+        return Kernels::gradedAntilexLess(lhs, rhs);
     }
 
-    void inc(PointImplType & data) {
-        using namespace std::tr1::placeholders;
-        using std::tr1::bind;
-        typename PointImplType::iterator
-                itInc = std::find_if(data.begin(), data.end(),
-                    std::tr1::bind(std::logical_not<bool>(),
-                            std::tr1::bind(std::equal_to<int>(), 0, _1))),
-                it(itInc++);
-        if (it == data.end())
-            data[0] = 1;
-        else if (itInc == data.end()) {
-            int a = *it + 1;
-            *it = 0;
-            data[0] = a;
-        } else {
-            ++(*itInc);
-            int a = *it - 1;
-            *it = 0;
-            data[0] = a;
-        }
+    static void inc(PointImplType & data) {
+        Kernels::gradedAntilexInc(data);
     }
-};
-
-template <int a, int b>
-class LpSolveHolder {
-    static const int dim = 2;
-
-    glp_prob *lp;
-
-    glp_iocp parm;
-
-public:
-    LpSolveHolder() {
-        glp_term_out(GLP_OFF);
-
-        const int ne = 2;
-        int ia[1 + ne], ja[1 + ne];
-        double ar[1 + ne];
 
-        lp = glp_create_prob();
+    /// Every point of the lattice is enumerated by \c inc.
+    static bool isCanonical(PointImplType const &) {
+        return true;
+    }
 
-        glp_set_obj_dir(lp, GLP_MIN);
+private:
+    typedef CoordinateKernels<std::tuple_size<PointImplType>::value> Kernels;
+};
 
-        glp_add_rows(lp, 1);
+/**
+ * Weighted monomial order on the plane: points are compared by the weight
+ * a*x_1 + b*x_2. To make the order total the first coordinate is kept within
+ * [0, b - 1] (this is the case for Hermitian codes where x^{r+1} is reduced
+ * by the curve equation), so for coprime \c a and \c b every weight has at
+ * most one representative.
+ *
+ * The policy is stateless: incrementing a point solves the tiny integer
+ * program “min a*x_1 + b*x_2 s.t. a*x_1 + b*x_2 > w” by direct enumeration
+ * instead of calling a shared LP solver, so points may be incremented
+ * concurrently from any number of threads.
+ */
+template<int a, int b>
+struct WeightedOrder {
 
-        glp_add_cols(lp, 2);
-        glp_set_col_bnds(lp, 1, GLP_DB, 0.0, b - 1); // x1
-        glp_set_col_bnds(lp, 2, GLP_LO, 0.0, 0.0); // x2
+    template<typename PointImpl>
+    struct impl {
+        typedef PointImpl PointImplType;
 
-        glp_set_col_kind(lp, 1, GLP_IV);
-        glp_set_col_kind(lp, 2, GLP_IV);
+        static bool totalLess(PointImplType const & lhs, PointImplType const & rhs) {
+            return weight(lhs) < weight(rhs);
+        }
 
-        glp_set_obj_coef(lp, 1, a);
-        glp_set_obj_coef(lp, 2, b);
+        static void inc(PointImplType & data) {
+            for (long w = weight(data) + 1; ; ++w) {
+                for (long x1 = 0; x1 < b && a*x1 <= w; ++x1) {
+                    if ((w - a*x1) % b == 0) {
+                        data[0] = x1;
+                        data[1] = (w - a*x1) / b;
+                        return;
+                    }
+                }
+            }
+        }
 
-        ia[1] = 1, ja[1] = 1, ar[1] = a;
-        ia[2] = 1, ja[2] = 2, ar[2] = b;
+        /// Only points with the first coordinate in [0, b - 1] are enumerated.
+        static bool isCanonical(PointImplType const & data) {
+            return 0 <= data[0] && data[0] < b;
+        }
 
-        glp_load_matrix(lp, 2, ia, ja, ar);
-        //glp_simplex(lp, NULL);
-        glp_init_iocp(&parm);
-        parm.presolve = GLP_ON;
-    }
+    private:
+        static long weight(PointImplType const & data) {
+            return a*data[0] + b*data[1];
+        }
 
-    template <typename Cont>
-    void lpInc(Cont & c) {
-        glp_set_row_bnds(lp, 1, GLP_LO, c[0]*a + c[1]*b + 1, 0.0);
-        glp_intopt(lp, &parm);
-        c[0] = glp_mip_col_val(lp, 1);
-        c[1] = glp_mip_col_val(lp, 2);
-    }
+    };
 
-    ~LpSolveHolder() {
-        glp_delete_prob(lp);
-    }
 };
 
+/**
+ * Weighted monomial order on the whole plane: points are compared by the
+ * weight a*x_1 + b*x_2, the points of the same weight by the first
+ * coordinate (so x^b > y^a). Unlike WeightedOrder every point of the lattice
+ * is enumerated, which makes it a monomial order in the proper sense:
+ * BMS-algorithm with this order finds the Groebner basis of the ideal of
+ * linear recurrences of a sequence on the plane (e.g. syndromes of an
+ * algebraic-geometric code extended by the curve equation).
+ */
 template<int a, int b>
-struct WeightedOrder {
+struct WeightedMonomialOrder {
 
     template<typename PointImpl>
     struct impl {
         typedef PointImpl PointImplType;
 
         static bool totalLess(PointImplType const & lhs, PointImplType const & rhs) {
-            return weight(lhs) < weight(rhs);
+            long const wl = weight(lhs), wr = weight(rhs);
+            return wl < wr || (wl == wr && lhs[0] < rhs[0]);
         }
 
         static void inc(PointImplType & data) {
-            lp.lpInc(data);
+            // the next point of the same weight, if any
+            if (data[1] >= a) {
+                data[0] += b;
+                data[1] -= a;
+                return;
+            }
+            for (long w = weight(data) + 1; ; ++w) {
+                for (long x1 = 0; x1 < b && a*x1 <= w; ++x1) {
+                    if ((w - a*x1) % b == 0) {
+                        data[0] = x1;
+                        data[1] = (w - a*x1) / b;
+                        return;
+                    }
+                }
+            }
         }
 
+        /// Every point of the lattice is enumerated by \c inc.
+        static bool isCanonical(PointImplType const &) {
+            return true;
+        }
 
     private:
-        static LpSolveHolder<a, b> lp;
-
-        static int weight(PointImplType const & data) {
+        static long weight(PointImplType const & data) {
             return a*data[0] + b*data[1];
         }
 
@@ -312,12 +502,6 @@ struct WeightedOrder {
 
 };
 
-template <int a, int b>
-template <typename T>
-LpSolveHolder<a, b>
-WeightedOrder<a, b>::impl<T>::lp = LpSolveHolder<a, b>();
-
-
 /**
  * Simple Point output.
  * @param[out] os Target output stream.
@@ -363,8 +547,7 @@ inline
 bool byCoordinateLess(
         Point<Dim, OrderPolicy> const & lhs,
         Point<Dim, OrderPolicy> const & rhs) {
-    return std::inner_product(lhs.begin(), lhs.end(), rhs.begin(), true,
-            std::logical_and<bool>(), std::less_equal<int>());
+    return CoordinateKernels<Dim>::lessEqual(lhs, rhs);
 }
 
 /**
@@ -381,11 +564,10 @@ bool byCoordinateLess(
 template<int Dim, template <typename PointImpl> class OrderPolicy, typename It>
 inline
 bool byCoordinateLessThenAny(Point<Dim, OrderPolicy> const & pt, It beg, It end) {
-    using std::tr1::bind;
-    using std::tr1::placeholders::_1;
-    using std::tr1::cref;
-    return end != std::find_if(beg, end,
-            std::tr1::bind(&byCoordinateLess<Dim, OrderPolicy>, cref(pt), _1));
+    for (; beg != end; ++beg)
+        if (byCoordinateLess(pt, *beg))
+            return true;
+    return false;
 }
 
 /**
@@ -414,11 +596,10 @@ template<int Dim, template <typename PointImpl> class OrderPolicy, typename PtCo
 inline
 bool byCoordinateGreaterThenAny(Point<Dim, OrderPolicy> const & pt,
         PtCont const & c) {
-    using std::tr1::bind;
-    using std::tr1::placeholders::_1;
-    using std::tr1::cref;
-    return c.end() != std::find_if(c.begin(), c.end(),
-            bind(&byCoordinateLess<Dim, OrderPolicy>, _1, cref(pt)));
+    for (typename PtCont::const_iterator it = c.begin(); it != c.end(); ++it)
+        if (byCoordinateLess(*it, pt))
+            return true;
+    return false;
 }
 
 /**
@@ -486,22 +667,25 @@ operator-(Point<Dim, OrderPolicy> lhs, Point<Dim, OrderPolicy> const & rhs) {
  * Gets all partial maximums from collection of \c Point (\c points) with
  * respect to by-coordinate partial order (cf. \c byCoordinateLess).
  * @param points Collection of points to be looked through for the maximums.
- * @return Maximum points with respect to by-coordinate partial order
- * (cf. \c byCoordinateLess) from the \c points.
+ * @param result Collection for maximum points with respect to
+ * by-coordinate partial order (cf. \c byCoordinateLess) from the \c points,
+ * cleared first (so a vector reused across calls keeps its storage).
  */
 template<
     int Dim,
     template <typename PointImpl> class OrderPolicy,
     template<typename T, typename S = std::allocator<T> > class Cont>
-Cont<Point<Dim, OrderPolicy> >
-getPartialMaximums(Cont<Point<Dim, OrderPolicy> > const & points) {
+void
+getPartialMaximums(
+        Cont<Point<Dim, OrderPolicy> > const & points,
+        Cont<Point<Dim, OrderPolicy> > & result) {
     using std::tr1::bind;
     using std::tr1::placeholders::_1; // usually we use “using” directive:
     // using namespace std::tr1::placeholders; — but here it yelds some ambiguity
     // while resolving _1 symbol, so we use declaration. Sad but true...
     using std::tr1::cref;
     using std::find_if;
-    Cont<Point<Dim, OrderPolicy> > result;
+    result.clear();
     typedef Point<Dim, OrderPolicy> Pt;
     BOOST_FOREACH(Pt const & pt, points) {
         // if there is a point in result which dominates pt, then throw pt away
@@ -511,30 +695,50 @@ getPartialMaximums(Cont<Point<Dim, OrderPolicy> > const & points) {
         // in result dominated by pt
         result.erase(
                 remove_if(result.begin(), result.end(),
-                        bind(&byCoordinateLess<Dim, OrderPolicy>, _1, cref(pt))),
+                        std::tr1::bind(&byCoordinateLess<Dim, OrderPolicy>, _1, cref(pt))),
                 result.end());
         result.push_back(pt);
     }
-    return result;
 }
 
 /**
- * Complimentary to \c getPartialMaximums.
+ * Gets all partial maximums from collection of \c Point (\c points) with
+ * respect to by-coordinate partial order (cf. \c byCoordinateLess).
  * @param points Collection of points to be looked through for the maximums.
  * @return Maximum points with respect to by-coordinate partial order
  * (cf. \c byCoordinateLess) from the \c points.
  */
-template<int Dim, template <typename PointImpl> class OrderPolicy,
+template<
+    int Dim,
+    template <typename PointImpl> class OrderPolicy,
     template<typename T, typename S = std::allocator<T> > class Cont>
 Cont<Point<Dim, OrderPolicy> >
-getPartialMinimums(Cont<Point<Dim, OrderPolicy> > const & points) {
+getPartialMaximums(Cont<Point<Dim, OrderPolicy> > const & points) {
+    Cont<Point<Dim, OrderPolicy> > result;
+    getPartialMaximums(points, result);
+    return result;
+}
+
+/**
+ * Complimentary to \c getPartialMaximums.
+ * @param points Collection of points to be looked through for the minimums.
+ * @param result Collection for minimum points with respect to
+ * by-coordinate partial order (cf. \c byCoordinateLess) from the \c points,
+ * cleared first.
+ */
+template<int Dim, template <typename PointImpl> class OrderPolicy,
+    template<typename T, typename S = std::allocator<T> > class Cont>
+void
+getPartialMinimums(
+        Cont<Point<Dim, OrderPolicy> > const & points,
+        Cont<Point<Dim, OrderPolicy> > & result) {
     // TODO: probably we should refactor out this function together with
     // getPartialMaximums to get one generic function
     using std::tr1::bind;
     using std::tr1::placeholders::_1;
     using std::tr1::cref;
     using std::find_if;
-    Cont<Point<Dim, OrderPolicy> > result;
+    result.clear();
     typedef Point<Dim, OrderPolicy> Pt;
     BOOST_FOREACH(Pt const & pt, points) {
         // if there is a point in result which dominates pt, then throw pt away
@@ -544,50 +748,103 @@ getPartialMinimums(Cont<Point<Dim, OrderPolicy> > const & points) {
         // in result dominated by pt
         result.erase(
                 remove_if(result.begin(), result.end(),
-                        bind(&byCoordinateLess<Dim, OrderPolicy>, _1, cref(pt))),
+                        std::tr1::bind(&byCoordinateLess<Dim, OrderPolicy>, _1, cref(pt))),
                 result.end());
         result.push_back(pt);
     }
+}
+
+/**
+ * Complimentary to \c getPartialMaximums.
+ * @param points Collection of points to be looked through for the minimums.
+ * @return Minimum points with respect to by-coordinate partial order
+ * (cf. \c byCoordinateLess) from the \c points.
+ */
+template<int Dim, template <typename PointImpl> class OrderPolicy,
+    template<typename T, typename S = std::allocator<T> > class Cont>
+Cont<Point<Dim, OrderPolicy> >
+getPartialMinimums(Cont<Point<Dim, OrderPolicy> > const & points) {
+    Cont<Point<Dim, OrderPolicy> > result;
+    getPartialMinimums(points, result);
     return result;
 }
 
+/**
+ * Finite approximation of Sigma-set for the Delta-set given by its
+ * maximal \c points (which must be nonempty): the canonical points of the
+ * box exceeding \c points by at most one in every coordinate that are not
+ * in Delta-set, stored into \c result (cleared first).
+ */
+template<int Dim, template <typename PointImpl> class OrderPolicy, typename PtCont>
+void
+getSigmaSetApproximation(PtCont const & points, PtCont & result) {
+    // the approximation set is the box of points exceeding the given ones
+    // by at most one in every coordinate: if a minimal point s of Sigma-set
+    // had s[i] > max pt[i] + 1, then s - e_i would be in Sigma-set as well.
+    // (The box doesn't depend on the monomial order, unlike the points
+    // below some weight, which miss e.g. (0, j) for weighted orders; only
+    // the points the order enumerates are taken, cf. Point::isCanonical.)
+    typedef Point<Dim, OrderPolicy> Pt;
+    result.clear();
+    Pt upper;
+    BOOST_FOREACH(Pt const & pt, points)
+        for (int c = 0; c < Dim; ++c)
+            upper[c] = std::max<long>(upper[c], pt[c] + 1);
+    for (Pt i; ; ) {
+        if (i.isCanonical() && ! byCoordinateLessThenAny(i, points))
+            result.push_back(i);
+        int c = Dim - 1;
+        while (c >= 0 && i[c] == upper[c])
+            i[c--] = 0;
+        if (c < 0)
+            break;
+        ++i[c];
+    }
+}
+
 template<int Dim, template <typename PointImpl> class OrderPolicy,
     template<typename T, typename S = std::allocator<T> > class Cont>
 Cont<Point<Dim, OrderPolicy> >
 getConjugatePointCollection(Cont<Point<Dim, OrderPolicy> > const & points) {
     // construct some finite approximation set of Sigma-set, which contains conjugate
     // point set to be found; then we use exhaustive search in this finite set for
-    // finding extremums (minimums in this case) as usual (see getPartialMaximums);
-    // the approximation set defined as follows (and this definition is a
-    // subject of probable future optimization, specification
-    // and even correction ;)): it is all points totally
-    // less (w.r.t. monomial order) then the point which has a weight equal to
-    // the maximum weight of points in given collection plus 2
-    // but the (totally) least from all such points
-    // TODO: proof correctness of the algorithm
-    using std::tr1::bind;
-    using std::tr1::function;
-    using std::tr1::placeholders::_1;
-    using std::tr1::placeholders::_2;
+    // finding extremums (minimums in this case) as usual (see getPartialMaximums)
+    typedef Point<Dim, OrderPolicy> Pt;
     if (points.empty())
-        return Cont< Point<Dim, OrderPolicy> >(1);
-    //function<int (Point<Dim>)> pointWeight = bind(&Point<Dim>::weight, _1);
-    int max_weight = weight(*std::max_element(points.begin(), points.end(),
-            std::tr1::bind(std::less<int>(),
-                    std::tr1::bind(&weight< Point<Dim, OrderPolicy> >, _1),
-                    std::tr1::bind(&weight< Point<Dim, OrderPolicy> >, _2))));
-    Point<Dim, OrderPolicy> upperPoint;
-    upperPoint[0] = max_weight + 2;
-    Cont< Point<Dim, OrderPolicy> > approxSigmaSet;
-    for (Point<Dim, OrderPolicy> i; i < upperPoint; ++i) {
-        if (! byCoordinateLessThenAny(i, points))
-            approxSigmaSet.push_back(i);
-    }
-//    std::cout << "app set" << std::endl;
-//    std::copy(approxSigmaSet.begin(), approxSigmaSet.end(),
-//            std::ostream_iterator< Point<Dim> >(std::cout, "\n"));
-    return getPartialMinimums(approxSigmaSet);
+        return Cont<Pt>(1);
+    Cont<Pt> approxSigmaSet;
+    getSigmaSetApproximation<Dim, OrderPolicy>(points, approxSigmaSet);
+    // the collection follows the monomial order (as F is built in that order)
+    std::vector<Pt> result;
+    Cont<Pt> const minimums = getPartialMinimums(approxSigmaSet);
+    std::copy(minimums.begin(), minimums.end(), std::back_inserter(result));
+    std::sort(result.begin(), result.end());
+    return Cont<Pt>(result.begin(), result.end());
+}
+
+/**
+ * Same as above for vectors: the conjugate points are stored into
+ * \c result (cleared first) using \c approxSigmaSet as a buffer, so that
+ * vectors reused across calls allocate only when they grow.
+ */
+template<int Dim, template <typename PointImpl> class OrderPolicy>
+void
+getConjugatePointCollection(
+        std::vector< Point<Dim, OrderPolicy> > const & points,
+        std::vector< Point<Dim, OrderPolicy> > & result,
+        std::vector< Point<Dim, OrderPolicy> > & approxSigmaSet) {
+    typedef Point<Dim, OrderPolicy> Pt;
+    result.clear();
+    if (points.empty()) {
+        result.push_back(Pt());
+        return;
+    }
+    getSigmaSetApproximation<Dim, OrderPolicy>(points, approxSigmaSet);
+    getPartialMinimums(approxSigmaSet, result);
+    // the collection follows the monomial order (as F is built in that order)
+    std::sort(result.begin(), result.end());
 }
+
 /**
  * Point slice. It is kind of Decorator (cf. [GoF]) for point instance which
  * shifts the index used in \c Point subscript operator on \c Offset
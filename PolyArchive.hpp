@@ -0,0 +1,549 @@
+/**
+ * @file PolyArchive.hpp
+ *
+ * Versioned binary archive of multivariate polynomials and of collections
+ * of them (e.g. the minimal sets of BMS-algorithm, cf.
+ * BMSAlgorithm::PolynomialCollection), for storing many of them in one
+ * file. Unlike Serialization.hpp, the coefficients are packed densely with
+ * fixed width, so an archive mapped to memory (cf. MappedFile) is read in
+ * place: PolyArchiveView and PackedPolynomialView give the coefficients
+ * without copying or parsing the file.
+ *
+ * Layout (all integers little-endian, blocks aligned at 8 bytes):
+ *   - header: magic <tt>MVPA</tt>, version (2 bytes), number of variables
+ *     (2 bytes), field descriptor: kind (1 byte), coefficient width in
+ *     bytes (1 byte, 0 for bits), modulus length (2 bytes) and bytes;
+ *   - records: number of polynomials (4 bytes, 4 reserved), for every
+ *     polynomial the extents of its box of coefficients (4 bytes each)
+ *     and the packed coefficients of the box in row-major order;
+ *   - index: offsets of the records (8 bytes each);
+ *   - footer: offset of the index, number of records (8 bytes each),
+ *     magic <tt>MVPAIDX</tt>.
+ *
+ * Malformed archives and archives of another field are reported by
+ * std::runtime_error.
+ */
+
+#ifndef POLYARCHIVE_HPP_
+#define POLYARCHIVE_HPP_
+
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <cstdint>
+#include <cstring>
+
+#include <NTL/GF2.h>
+#include <NTL/GF2E.h>
+#include <NTL/GF2X.h>
+#include <NTL/ZZ.h>
+#include <NTL/ZZ_p.h>
+
+#include <glog/logging.h>
+
+#include "mv_poly.hpp"
+#include "CoefficientTraits.hpp"
+#include "MappedFile.hpp"
+#include "SequenceView.hpp"
+#include "Serialization.hpp"
+
+namespace mv_poly {
+
+/// Kinds of the coefficients in the field descriptor of an archive.
+enum PackedCoefKind {
+    PACKED_INTEGER = 1,
+    PACKED_GF2 = 2,
+    PACKED_ZZ_P = 3,
+    PACKED_GF2E = 4
+};
+
+/// Reads the unsigned integer of \c bytes bytes at \c p (little-endian).
+inline uint64_t loadUInt(unsigned char const * p, int bytes) {
+    uint64_t result = 0;
+    for (int i = bytes - 1; i >= 0; --i)
+        result = (result << 8) | p[i];
+    return result;
+}
+
+/**
+ * \class PackedTraits
+ * Fixed-width packing of coefficients of type T: the field descriptor
+ * (\c KIND, <tt>width()</tt> and <tt>modulus()</tt>, the latter two taken
+ * from the current NTL modulus) and <tt>store(coefs, i, c)</tt>,
+ * <tt>load(coefs, i, c)</tt> of the i-th coefficient of a packed block.
+ * Specialized for integral types, GF2, ZZ_p and GF2E.
+ */
+template<typename T, typename Enable = void>
+struct PackedTraits;
+
+/// Two's complement in sizeof(T) bytes.
+template<typename T>
+struct PackedTraits<
+        T,
+        typename boost::enable_if< boost::is_integral<T> >::type > {
+
+    static int const KIND = PACKED_INTEGER;
+
+    static int width() {
+        return sizeof(T);
+    }
+
+    static std::vector<unsigned char> modulus() {
+        return std::vector<unsigned char>();
+    }
+
+    static void store(unsigned char * coefs, long i, T const & c) {
+        uint64_t v = static_cast<uint64_t>(static_cast<int64_t>(c));
+        for (int b = 0; b < width(); ++b, v >>= 8)
+            coefs[i * width() + b] = static_cast<unsigned char>(v & 0xff);
+    }
+
+    static void load(unsigned char const * coefs, long i, T & c) {
+        uint64_t v = loadUInt(coefs + i * width(), width());
+        if (std::is_signed<T>::value && width() < 8
+                && (v >> (8 * width() - 1)) & 1)
+            v |= ~uint64_t(0) << (8 * width());
+        c = static_cast<T>(static_cast<int64_t>(v));
+    }
+};
+
+/// One bit per coefficient.
+template<>
+struct PackedTraits<NTL::GF2> {
+    static int const KIND = PACKED_GF2;
+
+    static int width() {
+        return 0;
+    }
+
+    static std::vector<unsigned char> modulus() {
+        return std::vector<unsigned char>();
+    }
+
+    static void store(unsigned char * coefs, long i, NTL::GF2 const & c) {
+        if (NTL::rep(c))
+            coefs[i / 8] |= static_cast<unsigned char>(1 << (i % 8));
+    }
+
+    static void load(unsigned char const * coefs, long i, NTL::GF2 & c) {
+        NTL::conv(c, long((coefs[i / 8] >> (i % 8)) & 1));
+    }
+};
+
+/// Representative in [0, p) in as many bytes as p has.
+template<>
+struct PackedTraits<NTL::ZZ_p> {
+    static int const KIND = PACKED_ZZ_P;
+
+    static int width() {
+        return NTL::NumBytes(NTL::ZZ_p::modulus());
+    }
+
+    static std::vector<unsigned char> modulus() {
+        NTL::ZZ const p = NTL::ZZ_p::modulus();
+        std::vector<unsigned char> bytes(NTL::NumBytes(p));
+        if (!bytes.empty())
+            NTL::BytesFromZZ(&bytes[0], p, bytes.size());
+        return bytes;
+    }
+
+    static void store(unsigned char * coefs, long i, NTL::ZZ_p const & c) {
+        NTL::BytesFromZZ(coefs + i * width(), NTL::rep(c), width());
+    }
+
+    static void load(unsigned char const * coefs, long i, NTL::ZZ_p & c) {
+        NTL::conv(c, NTL::ZZFromBytes(coefs + i * width(), width()));
+    }
+};
+
+/// Polynomial representation in as many bytes as the degree of the field needs.
+template<>
+struct PackedTraits<NTL::GF2E> {
+    static int const KIND = PACKED_GF2E;
+
+    static int width() {
+        return (NTL::GF2E::degree() + 7) / 8;
+    }
+
+    static std::vector<unsigned char> modulus() {
+        NTL::GF2X const & m = NTL::GF2E::modulus();
+        std::vector<unsigned char> bytes(NTL::NumBytes(m));
+        if (!bytes.empty())
+            NTL::BytesFromGF2X(&bytes[0], m, bytes.size());
+        return bytes;
+    }
+
+    static void store(unsigned char * coefs, long i, NTL::GF2E const & c) {
+        NTL::BytesFromGF2X(coefs + i * width(), NTL::rep(c), width());
+    }
+
+    static void load(unsigned char const * coefs, long i, NTL::GF2E & c) {
+        NTL::GF2X p;
+        NTL::GF2XFromBytes(p, coefs + i * width(), width());
+        NTL::conv(c, p);
+    }
+};
+
+/// Size in bytes of \c cnt packed coefficients of width \c width.
+inline uint64_t packedBytes(uint64_t cnt, int width) {
+    return width == 0 ? (cnt + 7) / 8 : cnt * width;
+}
+
+/// Rounds \c n up to the alignment of the archive blocks.
+inline uint64_t archiveAlign(uint64_t n) {
+    return (n + 7) & ~uint64_t(7);
+}
+
+/// \cond
+namespace archive_detail {
+
+char const MAGIC[4] = { 'M', 'V', 'P', 'A' };
+
+char const FOOTER_MAGIC[8] = { 'M', 'V', 'P', 'A', 'I', 'D', 'X', 0 };
+
+uint64_t const FOOTER_SIZE = 24;
+
+uint64_t const RECORD_HEADER_SIZE = 8;
+
+} // namespace archive_detail
+/// \endcond
+
+/**
+ * \class PackedPolynomialView
+ * Polynomial in an archive: the box of its coefficients (cf. BoxLayout)
+ * and a pointer to the packed coefficients, which the view doesn't own.
+ */
+template<int Dim, typename T>
+class PackedPolynomialView {
+public:
+    typedef typename MVPolyType<Dim, T>::type PolynomialT;
+
+    typedef BoxLayout<Dim> Layout;
+
+    PackedPolynomialView(Layout const & layout_, unsigned char const * coefs_) :
+        layout(layout_), coefs(coefs_) {}
+
+    Layout const & getLayout() const {
+        return layout;
+    }
+
+    /// Number of the packed coefficients (the points of the box).
+    long size() const {
+        return layout.size();
+    }
+
+    /// Coefficient with rank \c r in the box.
+    T coefficient(long r) const {
+        T result;
+        PackedTraits<T>::load(coefs, r, result);
+        return result;
+    }
+
+    /// Coefficient of the monomial of degree \c pt, zero outside the box.
+    template<typename Pt>
+    T operator[](Pt const & pt) const {
+        if (!layout.contains(pt))
+            return CoefficientTraits<T>::addId();
+        return coefficient(layout.rank(pt));
+    }
+
+    /// Packed coefficients.
+    unsigned char const * data() const {
+        return coefs;
+    }
+
+    /// Copy of the polynomial.
+    PolynomialT materialize() const {
+        T const zero = CoefficientTraits<T>::addId();
+        PolynomialT result;
+        std::array<long, Dim> pt;
+        for (long r = 0; r < size(); ++r) {
+            T const c = coefficient(r);
+            if (c == zero)
+                continue;
+            layout.unrank(r, pt);
+            setCoefficient(result, pt, c);
+        }
+        return result;
+    }
+
+private:
+    Layout layout;
+
+    unsigned char const * coefs;
+};
+
+/**
+ * \class PolyArchiveWriter
+ * Writes an archive of polynomials with Dim variables over T to a stream:
+ * a record per call of \c write or \c writeCollection, the index on \c
+ * finish (or destruction). The field descriptor is taken from the NTL
+ * modulus set at construction.
+ */
+template<int Dim, typename T>
+class PolyArchiveWriter {
+public:
+    typedef typename MVPolyType<Dim, T>::type PolynomialT;
+
+    static int const FORMAT_VERSION = 1;
+
+    explicit PolyArchiveWriter(std::ostream & os_) :
+            os(os_), offset(0), width(PackedTraits<T>::width()),
+            finished(false) {
+        std::vector<unsigned char> const modulus = PackedTraits<T>::modulus();
+        os.write(archive_detail::MAGIC, sizeof(archive_detail::MAGIC));
+        offset += sizeof(archive_detail::MAGIC);
+        put(FORMAT_VERSION, 2);
+        put(Dim, 2);
+        put(PackedTraits<T>::KIND, 1);
+        put(width, 1);
+        put(modulus.size(), 2);
+        for (size_t i = 0; i < modulus.size(); ++i)
+            put(modulus[i], 1);
+        pad();
+    }
+
+    ~PolyArchiveWriter() {
+        if (!finished)
+            finish();
+    }
+
+    /// Writes a record of the polynomials [begin, end).
+    template<typename Iter>
+    void writeCollection(Iter begin, Iter end) {
+        CHECK(!finished) << "Writing to finished archive";
+        index.push_back(offset);
+        put(std::distance(begin, end), 4);
+        put(0, 4);
+        for (; begin != end; ++begin)
+            writePolynomial(*begin);
+    }
+
+    template<typename Collection>
+    void writeCollection(Collection const & polys) {
+        writeCollection(polys.begin(), polys.end());
+    }
+
+    /// Writes a record of one polynomial.
+    void write(PolynomialT const & p) {
+        writeCollection(&p, &p + 1);
+    }
+
+    size_t getRecordCnt() const {
+        return index.size();
+    }
+
+    /// Writes the index and the footer, nothing can be written after it.
+    void finish() {
+        uint64_t const indexOffset = offset;
+        for (size_t i = 0; i < index.size(); ++i)
+            put(index[i], 8);
+        put(indexOffset, 8);
+        put(index.size(), 8);
+        os.write(archive_detail::FOOTER_MAGIC,
+                sizeof(archive_detail::FOOTER_MAGIC));
+        os.flush();
+        finished = true;
+    }
+
+private:
+    PolyArchiveWriter(PolyArchiveWriter const &);
+
+    PolyArchiveWriter & operator=(PolyArchiveWriter const &);
+
+    void put(uint64_t v, int bytes) {
+        writeUInt(os, v, bytes);
+        offset += bytes;
+    }
+
+    void pad() {
+        while (offset % 8 != 0)
+            put(0, 1);
+    }
+
+    void writePolynomial(PolynomialT const & p) {
+        typedef std::array<long, Dim> Pt;
+        typename BoxLayout<Dim>::Extents extents;
+        extents.fill(1);
+        forEachCoefficient<Pt>(p, [&extents](Pt const & pt, T const &) {
+            for (int i = 0; i < Dim; ++i)
+                extents[i] = std::max(extents[i], pt[i] + 1);
+        });
+        for (int i = 0; i < Dim; ++i) {
+            if (extents[i] > 0xffffffffl)
+                throw std::runtime_error("polynomial too large for archive");
+            put(extents[i], 4);
+        }
+        pad();
+
+        BoxLayout<Dim> const layout(extents);
+        std::vector<unsigned char> coefs(packedBytes(layout.size(), width));
+        unsigned char * const data = coefs.empty() ? 0 : &coefs[0];
+        forEachCoefficient<Pt>(p, [&layout, data](Pt const & pt, T const & c) {
+            PackedTraits<T>::store(data, layout.rank(pt), c);
+        });
+        if (!coefs.empty())
+            os.write(reinterpret_cast<char const *>(data), coefs.size());
+        offset += coefs.size();
+        pad();
+    }
+
+    std::ostream & os;
+
+    uint64_t offset;
+
+    int const width;
+
+    std::vector<uint64_t> index;
+
+    bool finished;
+};
+
+/**
+ * \class PolyArchiveView
+ * Archive written by PolyArchiveWriter in the bytes [begin, end) (e.g. of
+ * a MappedFile), which the view doesn't own. The header and the index are
+ * checked on construction (the field has to be the one of the current NTL
+ * modulus), the records when they are accessed.
+ */
+template<int Dim, typename T>
+class PolyArchiveView {
+public:
+    typedef typename MVPolyType<Dim, T>::type PolynomialT;
+
+    typedef PackedPolynomialView<Dim, T> PolynomialView;
+
+    PolyArchiveView(char const * begin_, char const * end_) :
+            begin(reinterpret_cast<unsigned char const *>(begin_)),
+            size(end_ - begin_), width(PackedTraits<T>::width()) {
+        using namespace archive_detail;
+        if (size < 12 + FOOTER_SIZE
+                || std::memcmp(begin, MAGIC, sizeof(MAGIC)) != 0)
+            throw std::runtime_error("not a polynomial archive");
+        if (loadUInt(begin + 4, 2) !=
+                uint64_t(PolyArchiveWriter<Dim, T>::FORMAT_VERSION))
+            throw std::runtime_error("unsupported archive version");
+        if (loadUInt(begin + 6, 2) != uint64_t(Dim))
+            throw std::runtime_error("archive of polynomials in another number of variables");
+        std::vector<unsigned char> const modulus = PackedTraits<T>::modulus();
+        uint64_t const modulusSize = loadUInt(begin + 10, 2);
+        if (loadUInt(begin + 8, 1) != uint64_t(PackedTraits<T>::KIND)
+                || loadUInt(begin + 9, 1) != uint64_t(width)
+                || modulusSize != modulus.size()
+                || 12 + modulusSize > size - FOOTER_SIZE
+                || !std::equal(modulus.begin(), modulus.end(), begin + 12))
+            throw std::runtime_error("archive of another field");
+
+        unsigned char const * const footer = begin + size - FOOTER_SIZE;
+        if (std::memcmp(footer + 16, FOOTER_MAGIC, sizeof(FOOTER_MAGIC)) != 0)
+            throw std::runtime_error("truncated archive");
+        indexOffset = loadUInt(footer, 8);
+        recordCnt = loadUInt(footer + 8, 8);
+        if (indexOffset > size - FOOTER_SIZE
+                || recordCnt > (size - FOOTER_SIZE - indexOffset) / 8)
+            throw std::runtime_error("malformed archive index");
+    }
+
+    explicit PolyArchiveView(MappedFile const & file) :
+            PolyArchiveView(file.begin(), file.end()) {}
+
+    size_t getRecordCnt() const {
+        return recordCnt;
+    }
+
+    /// Number of the polynomials in the record \c record.
+    size_t getPolynomialCnt(size_t record) const {
+        return loadUInt(begin + recordOffset(record), 4);
+    }
+
+    /**
+     * View of the i-th polynomial of the record \c record; the polynomials
+     * before it are skipped over (to read all of them cf. readCollection).
+     */
+    PolynomialView getPolynomial(size_t record, size_t i) const {
+        uint64_t offset = recordOffset(record);
+        size_t const cnt = loadUInt(begin + offset, 4);
+        if (i >= cnt)
+            throw std::out_of_range("no such polynomial in archive record");
+        offset += archive_detail::RECORD_HEADER_SIZE;
+        for (; i > 0; --i)
+            nextPolynomial(offset);
+        return nextPolynomial(offset);
+    }
+
+    /// Copy of the i-th polynomial of the record \c record.
+    PolynomialT readPolynomial(size_t record, size_t i = 0) const {
+        return getPolynomial(record, i).materialize();
+    }
+
+    /**
+     * Appends the polynomials of the record \c record to \c polys, walking
+     * the record once.
+     */
+    template<typename Collection>
+    void readCollection(size_t record, Collection & polys) const {
+        uint64_t offset = recordOffset(record);
+        size_t const cnt = loadUInt(begin + offset, 4);
+        offset += archive_detail::RECORD_HEADER_SIZE;
+        for (size_t i = 0; i < cnt; ++i)
+            polys.push_back(nextPolynomial(offset).materialize());
+    }
+
+private:
+    uint64_t recordOffset(size_t record) const {
+        if (record >= recordCnt)
+            throw std::out_of_range("no such archive record");
+        uint64_t const offset = loadUInt(begin + indexOffset + 8 * record, 8);
+        if (offset > indexOffset
+                || indexOffset - offset < archive_detail::RECORD_HEADER_SIZE)
+            throw std::runtime_error("malformed archive index");
+        return offset;
+    }
+
+    /**
+     * View of the polynomial at \c offset in a record, \c offset is moved
+     * to the next one.
+     */
+    PolynomialView nextPolynomial(uint64_t & offset) const {
+        typename BoxLayout<Dim>::Extents extents;
+        uint64_t const coefsOffset = archiveAlign(offset + 4 * Dim);
+        require(coefsOffset);
+        // a coefficient takes a bit at least
+        uint64_t const maxCells = 8 * size;
+        uint64_t cells = 1;
+        for (int d = 0; d < Dim; ++d) {
+            extents[d] = loadUInt(begin + offset + 4 * d, 4);
+            if (extents[d] != 0 && cells > maxCells / extents[d])
+                throw std::runtime_error("malformed archive record");
+            cells *= extents[d];
+        }
+        offset = archiveAlign(coefsOffset + packedBytes(cells, width));
+        require(offset);
+        return PolynomialView(BoxLayout<Dim>(extents), begin + coefsOffset);
+    }
+
+    /// Checks that the records don't run into the index.
+    void require(uint64_t offset) const {
+        if (offset > indexOffset)
+            throw std::runtime_error("truncated archive record");
+    }
+
+    unsigned char const * begin;
+
+    uint64_t size;
+
+    int const width;
+
+    uint64_t indexOffset;
+
+    uint64_t recordCnt;
+};
+
+} // namespace mv_poly
+
+#endif /* POLYARCHIVE_HPP_ */
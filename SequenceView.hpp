@@ -0,0 +1,248 @@
+/**
+ * @file SequenceView.hpp
+ *
+ * Box layout of dense multi-indexed sequences and convolution restricted
+ * to the support of a polynomial.
+ *
+ * BMS-algorithm reads the sequence (a Polynomial or a map from points
+ * to field elements) with \c conv at points i + m - deg f for every
+ * point i below deg f in the monomial order. Here \c convSupport visits
+ * only the nonzero terms of f (collected once into SupportTerms) and reads
+ * a dense sequence (DenseSequence, a Polynomial or a map copied into it)
+ * by the rank of a point in the box layout, without bounds checks when the
+ * shifted support of f lies in the box.
+ */
+
+#ifndef SEQUENCEVIEW_HPP_
+#define SEQUENCEVIEW_HPP_
+
+#include <array>
+#include <utility>
+#include <vector>
+
+#include <cassert>
+
+#include "mv_poly.hpp"
+#include "Point.hpp"
+#include "CoefficientTraits.hpp"
+
+namespace mv_poly {
+
+/**
+ * Row-major layout of the box [0, extents[0]) x … x [0, extents[Dim - 1])
+ * of the integer lattice: the rank of the point pt in the box is
+ * <tt>sum pt[i] * strides[i]</tt>, the last coordinate changing fastest
+ * as in the storage of Polynomial.
+ * @param Dim Dimension of point lattice.
+ */
+template<int Dim>
+class BoxLayout {
+public:
+    typedef std::array<long, Dim> Extents;
+
+    BoxLayout() {
+        extents.fill(0);
+        strides.fill(0);
+    }
+
+    explicit BoxLayout(Extents const & extents_) : extents(extents_) {
+        long stride = 1;
+        for (int i = Dim - 1; i >= 0; --i) {
+            strides[i] = stride;
+            stride *= extents[i];
+        }
+    }
+
+    /// Number of points in the box.
+    long size() const {
+        long result = 1;
+        for (int i = 0; i < Dim; ++i)
+            result *= extents[i];
+        return result;
+    }
+
+    Extents const & getExtents() const { return extents; }
+
+    template<typename Pt>
+    bool contains(Pt const & pt) const {
+        for (int i = 0; i < Dim; ++i)
+            if (pt[i] < 0 || extents[i] <= pt[i])
+                return false;
+        return true;
+    }
+
+    /// Rank of \c pt in the box, \c pt is assumed to be inside the box.
+    template<typename Pt>
+    long rank(Pt const & pt) const {
+        long result = 0;
+        for (int i = 0; i < Dim; ++i)
+            result += pt[i] * strides[i];
+        return result;
+    }
+
+    /// Inverse of \c rank: stores into \c pt the point with rank \c r.
+    template<typename Pt>
+    void unrank(long r, Pt & pt) const {
+        for (int i = 0; i < Dim; ++i) {
+            pt[i] = r / strides[i];
+            r %= strides[i];
+        }
+    }
+
+private:
+    Extents extents;
+
+    Extents strides;
+};
+
+/**
+ * Nonzero terms of a polynomial f which are not greater than given degree
+ * (w.r.t. the monomial order) together with their bounding box. These are
+ * exactly the terms that contribute to <tt>conv(f, u, degf, m)</tt>, which
+ * visits only points enumerated by the order (cf. Point::isCanonical).
+ */
+template<typename PointT, typename Coef>
+class SupportTerms {
+public:
+    typedef Coef CoefT;
+
+    typedef Coef mapped_type;
+
+    typedef std::vector< std::pair<PointT, Coef> > TermCollection;
+
+    typedef typename TermCollection::const_iterator const_iterator;
+
+    SupportTerms() {}
+
+    template<typename T>
+    SupportTerms(Polynomial<T> const & f, PointT const & degf) {
+        assign(f, degf);
+    }
+
+    /// Replaces the terms with the ones of \c f, keeping the storage.
+    template<typename T>
+    void assign(Polynomial<T> const & f, PointT const & degf) {
+        const Coef zero = CoefficientTraits<Coef>::addId();
+        TermCollection & terms = this->terms;
+        terms.clear();
+        forEachCoefficient<PointT>(f,
+                [&terms, &degf, &zero](PointT const & pt, Coef const & c) {
+                    if (c != zero && pt.isCanonical() && pt <= degf)
+                        terms.push_back(std::make_pair(pt, c));
+                });
+        computeBounds();
+    }
+
+    void swap(SupportTerms & other) {
+        terms.swap(other.terms);
+        std::swap(lower, other.lower);
+        std::swap(upper, other.upper);
+    }
+
+    /**
+     * Turns the terms of f into the terms of x^u * f (monomial orders are
+     * compatible with multiplication, so the degree bound is shifted by u
+     * as well). Costs O(size()).
+     */
+    void shift(PointT const & u) {
+        typename TermCollection::iterator out = terms.begin();
+        for (typename TermCollection::iterator it = terms.begin();
+                it != terms.end(); ++it) {
+            it->first += u;
+            if (it->first.isCanonical())
+                *out++ = *it;
+        }
+        terms.erase(out, terms.end());
+        computeBounds();
+    }
+
+    const_iterator begin() const { return terms.begin(); }
+
+    const_iterator end() const { return terms.end(); }
+
+    size_t size() const { return terms.size(); }
+
+    bool empty() const { return terms.empty(); }
+
+    /// By-coordinate minimum of the support.
+    PointT const & getLower() const { return lower; }
+
+    /// By-coordinate maximum of the support.
+    PointT const & getUpper() const { return upper; }
+
+private:
+    void computeBounds() {
+        lower = upper = PointT();
+        for (const_iterator it = terms.begin(); it != terms.end(); ++it)
+            for (int i = 0; i < PointT::DIM; ++i) {
+                if (it == terms.begin() || it->first[i] < lower[i])
+                    lower[i] = it->first[i];
+                if (it == terms.begin() || upper[i] < it->first[i])
+                    upper[i] = it->first[i];
+            }
+    }
+
+    TermCollection terms;
+
+    PointT lower;
+
+    PointT upper;
+};
+
+/**
+ * Support-restricted version of \c conv: the result is equal to
+ * <tt>conv(f, u, degf, m)</tt> for the polynomial f \c terms were built
+ * from, but only nonzero terms of f are visited.
+ * @param terms Support of f (cf. SupportTerms).
+ * @param u Sequence to convolute with: DenseSequence or any other dense
+ * sequence with \c contains, \c unchecked and \c operator[].
+ * @param degf The hint where to stop convolute.
+ * @param m The index of resulting sequence component.
+ * @return \c m-th component of the convolution.
+ */
+template<typename PointT, typename Coef, typename SeqT>
+inline
+Coef
+convSupport(
+        SupportTerms<PointT, Coef> const & terms,
+        SeqT const & u,
+        PointT const & degf,
+        PointT const & m) {
+    assert( byCoordinateLess(degf, m) );
+    typedef typename SupportTerms<PointT, Coef>::const_iterator It;
+    Coef res = CoefficientTraits<Coef>::addId();
+    if (terms.empty())
+        return res;
+    PointT const shift = m - degf;
+    if (u.contains(terms.getLower() + shift)
+            && u.contains(terms.getUpper() + shift)) {
+        for (It it = terms.begin(); it != terms.end(); ++it)
+            res += it->second * u.unchecked(it->first + shift);
+    } else {
+        for (It it = terms.begin(); it != terms.end(); ++it)
+            res += it->second * u[it->first + shift];
+    }
+    return res;
+}
+
+/**
+ * Support-restricted version of \c conv for polynomial \c f. The support
+ * of f is collected anew on every call: build SupportTerms once and use
+ * the overload above when f is convoluted at several points.
+ */
+template<typename T, typename SeqT, typename PointT>
+inline
+typename Polynomial<T>::CoefT
+convSupport(
+        Polynomial<T> const & f,
+        SeqT const & u,
+        PointT const & degf,
+        PointT const & m) {
+    return convSupport(
+            SupportTerms<PointT, typename Polynomial<T>::CoefT>(f, degf),
+            u, degf, m);
+}
+
+} // namespace mv_poly
+
+#endif /* SEQUENCEVIEW_HPP_ */
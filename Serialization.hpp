@@ -0,0 +1,254 @@
+/**
+ * @file Serialization.hpp
+ *
+ * Compact binary encoding of points, polynomials and their coefficients
+ * (machine integers and NTL field elements), used for checkpoints of
+ * BMS-algorithm.
+ *
+ * All integers are written in little-endian byte order with fixed width,
+ * so the data is portable between platforms. Truncated or malformed input
+ * is reported by std::runtime_error.
+ */
+
+#ifndef SERIALIZATION_HPP_
+#define SERIALIZATION_HPP_
+
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <cstdint>
+
+#include <boost/type_traits/is_integral.hpp>
+#include <boost/utility/enable_if.hpp>
+
+#include <NTL/GF2.h>
+#include <NTL/GF2E.h>
+#include <NTL/GF2X.h>
+#include <NTL/ZZ.h>
+#include <NTL/ZZ_p.h>
+#include <NTL/ZZ_pE.h>
+#include <NTL/ZZ_pX.h>
+
+#include "mv_poly.hpp"
+#include "Point.hpp"
+
+namespace mv_poly {
+
+/// Writes the \c bytes lower bytes of \c v (little-endian).
+inline void writeUInt(std::ostream & os, uint64_t v, int bytes = 8) {
+    for (int i = 0; i < bytes; ++i) {
+        os.put(static_cast<char>(v & 0xff));
+        v >>= 8;
+    }
+}
+
+/// Reads unsigned integer written by \c writeUInt.
+inline uint64_t readUInt(std::istream & is, int bytes = 8) {
+    uint64_t result = 0;
+    for (int i = 0; i < bytes; ++i) {
+        int c = is.get();
+        if (c == std::char_traits<char>::eof())
+            throw std::runtime_error("truncated binary data");
+        result |= static_cast<uint64_t>(static_cast<unsigned char>(c)) << (8 * i);
+    }
+    return result;
+}
+
+inline void writeBytes(std::ostream & os, std::vector<unsigned char> const & bytes) {
+    writeUInt(os, bytes.size());
+    if (!bytes.empty())
+        os.write(reinterpret_cast<char const *>(&bytes[0]), bytes.size());
+}
+
+inline std::vector<unsigned char> readBytes(std::istream & is) {
+    uint64_t const n = readUInt(is);
+    std::vector<unsigned char> bytes;
+    // don't trust the length before the bytes are actually read
+    for (uint64_t i = 0; i < n; ++i)
+        bytes.push_back(static_cast<unsigned char>(readUInt(is, 1)));
+    return bytes;
+}
+
+/**
+ * \class BinaryTraits
+ * Binary encoding of values of type T: <tt>write(os, value)</tt> and
+ * <tt>read(is, value)</tt>. Specialized for integral types, NTL integers and
+ * field elements, points and polynomials.
+ */
+template<typename T, typename Enable = void>
+struct BinaryTraits;
+
+template<typename T>
+struct BinaryTraits<
+        T,
+        typename boost::enable_if< boost::is_integral<T> >::type > {
+
+    static void write(std::ostream & os, T const & v) {
+        writeUInt(os, static_cast<uint64_t>(static_cast<int64_t>(v)));
+    }
+
+    static void read(std::istream & is, T & v) {
+        v = static_cast<T>(static_cast<int64_t>(readUInt(is)));
+    }
+};
+
+/// Sign and magnitude bytes.
+template<>
+struct BinaryTraits<NTL::ZZ> {
+    static void write(std::ostream & os, NTL::ZZ const & z) {
+        writeUInt(os, NTL::sign(z) < 0, 1);
+        NTL::ZZ const a = NTL::abs(z);
+        std::vector<unsigned char> bytes(NTL::NumBytes(a));
+        if (!bytes.empty())
+            NTL::BytesFromZZ(&bytes[0], a, bytes.size());
+        writeBytes(os, bytes);
+    }
+
+    static void read(std::istream & is, NTL::ZZ & z) {
+        bool const negative = readUInt(is, 1);
+        std::vector<unsigned char> const bytes = readBytes(is);
+        z = NTL::ZZFromBytes(bytes.empty() ? 0 : &bytes[0], bytes.size());
+        if (negative)
+            z = -z;
+    }
+};
+
+template<>
+struct BinaryTraits<NTL::GF2> {
+    static void write(std::ostream & os, NTL::GF2 const & a) {
+        writeUInt(os, NTL::rep(a), 1);
+    }
+
+    static void read(std::istream & is, NTL::GF2 & a) {
+        NTL::conv(a, static_cast<long>(readUInt(is, 1)));
+    }
+};
+
+/// Representative in [0, p), the modulus is supposed to be set on reading.
+template<>
+struct BinaryTraits<NTL::ZZ_p> {
+    static void write(std::ostream & os, NTL::ZZ_p const & a) {
+        BinaryTraits<NTL::ZZ>::write(os, NTL::rep(a));
+    }
+
+    static void read(std::istream & is, NTL::ZZ_p & a) {
+        NTL::ZZ z;
+        BinaryTraits<NTL::ZZ>::read(is, z);
+        NTL::conv(a, z);
+    }
+};
+
+template<>
+struct BinaryTraits<NTL::GF2X> {
+    static void write(std::ostream & os, NTL::GF2X const & p) {
+        std::vector<unsigned char> bytes(NTL::NumBytes(p));
+        if (!bytes.empty())
+            NTL::BytesFromGF2X(&bytes[0], p, bytes.size());
+        writeBytes(os, bytes);
+    }
+
+    static void read(std::istream & is, NTL::GF2X & p) {
+        std::vector<unsigned char> const bytes = readBytes(is);
+        NTL::GF2XFromBytes(p, bytes.empty() ? 0 : &bytes[0], bytes.size());
+    }
+};
+
+/// Polynomial representation, the modulus is supposed to be set on reading.
+template<>
+struct BinaryTraits<NTL::GF2E> {
+    static void write(std::ostream & os, NTL::GF2E const & a) {
+        BinaryTraits<NTL::GF2X>::write(os, NTL::rep(a));
+    }
+
+    static void read(std::istream & is, NTL::GF2E & a) {
+        NTL::GF2X p;
+        BinaryTraits<NTL::GF2X>::read(is, p);
+        NTL::conv(a, p);
+    }
+};
+
+/// Polynomial representation, the moduli are supposed to be set on reading.
+template<>
+struct BinaryTraits<NTL::ZZ_pE> {
+    static void write(std::ostream & os, NTL::ZZ_pE const & a) {
+        NTL::ZZ_pX const & p = NTL::rep(a);
+        long const n = NTL::deg(p) + 1;
+        writeUInt(os, n);
+        for (long i = 0; i < n; ++i)
+            BinaryTraits<NTL::ZZ_p>::write(os, NTL::coeff(p, i));
+    }
+
+    static void read(std::istream & is, NTL::ZZ_pE & a) {
+        uint64_t const n = readUInt(is);
+        NTL::ZZ_pX p;
+        for (uint64_t i = 0; i < n; ++i) {
+            NTL::ZZ_p c;
+            BinaryTraits<NTL::ZZ_p>::read(is, c);
+            NTL::SetCoeff(p, i, c);
+        }
+        NTL::conv(a, p);
+    }
+};
+
+template<int Dim, template <typename PointImpl> class OrderPolicy>
+struct BinaryTraits< Point<Dim, OrderPolicy> > {
+    static void write(std::ostream & os, Point<Dim, OrderPolicy> const & pt) {
+        for (int i = 0; i < Dim; ++i)
+            BinaryTraits<long>::write(os, pt[i]);
+    }
+
+    static void read(std::istream & is, Point<Dim, OrderPolicy> & pt) {
+        for (int i = 0; i < Dim; ++i)
+            BinaryTraits<long>::read(is, pt[i]);
+    }
+};
+
+/// Storage size and elements (recursively for multivariate polynomials).
+template<typename T>
+struct BinaryTraits< Polynomial<T> > {
+    static void write(std::ostream & os, Polynomial<T> const & p) {
+        typename Polynomial<T>::StorageT const & coefs = p.getCoefs();
+        writeUInt(os, coefs.size());
+        for (size_t i = 0; i < coefs.size(); ++i)
+            BinaryTraits<T>::write(os, coefs[i]);
+    }
+
+    static void read(std::istream & is, Polynomial<T> & p) {
+        uint64_t const n = readUInt(is);
+        if (n == 0)
+            throw std::runtime_error("polynomial without coefficients");
+        typename Polynomial<T>::StorageT coefs;
+        for (uint64_t i = 0; i < n; ++i) {
+            coefs.push_back(T());
+            BinaryTraits<T>::read(is, coefs.back());
+        }
+        p.setCoefs(coefs);
+    }
+};
+
+template<typename T>
+void writeBinary(std::ostream & os, T const & v) {
+    BinaryTraits<T>::write(os, v);
+}
+
+template<typename T>
+void readBinary(std::istream & is, T & v) {
+    BinaryTraits<T>::read(is, v);
+}
+
+/// 64-bit FNV-1a hash of the bytes of \c s.
+inline uint64_t fingerprint(std::string const & s) {
+    uint64_t h = 14695981039346656037ull;
+    for (size_t i = 0; i < s.size(); ++i) {
+        h ^= static_cast<unsigned char>(s[i]);
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+} // namespace mv_poly
+
+#endif /* SERIALIZATION_HPP_ */
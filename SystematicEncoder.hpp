@@ -0,0 +1,190 @@
+/**
+ * @file SystematicEncoder.hpp
+ *
+ * Systematic encoder of the codes decoded by BMSDecoding.
+ */
+
+#ifndef SYSTEMATICENCODER_HPP_
+#define SYSTEMATICENCODER_HPP_
+
+#include <algorithm>
+#include <vector>
+
+#include <cstddef>
+
+#include <glog/logging.h>
+
+#include "CoefficientTraits.hpp"
+#include "CodeContext.hpp"
+#include "MatrixProduct.hpp"
+#include "Trace.hpp"
+
+namespace mv_poly {
+
+/**
+ * \class SystematicEncoder
+ * Encoder of the code with the checks of \c context: the words with zero
+ * syndromes at the basis elements (cf. CodeContext::getBasis). The check
+ * matrix (the basis monomials at the points) is brought to the reduced row
+ * echelon form once, its pivot columns are the parity positions and the
+ * others the information positions. A message is written to the
+ * information positions as is and the parity symbols are the product of
+ * the precomputed parity matrix by it (cf. multiplyBlocked), so a batch of
+ * messages is encoded by one matrix product.
+ *
+ * The encoder doesn't change after the constructor, so it can be shared
+ * by threads as the context is.
+ */
+template<int Dim, typename ECCodeParams>
+class SystematicEncoder {
+public:
+    typedef CodeContext<Dim, ECCodeParams> Context;
+
+    typedef typename Context::Field Field;
+
+    typedef std::vector<Field> FieldElemsCollection;
+
+    /// The context has to outlive the encoder.
+    explicit SystematicEncoder(Context const & context_) :
+            context(context_), length(context_.getCurvePoints().size()) {
+        Field const zero = CoefficientTraits<Field>::addId();
+        auto const & basis = context.getBasis();
+        size_t const rows = basis.size();
+
+        // the check matrix in the reduced row echelon form
+        std::vector<Field> h(rows * length);
+        for (size_t i = 0; i < rows; ++i)
+            for (size_t p = 0; p < length; ++p)
+                h[i * length + p] = context.monomial(basis[i], p);
+        size_t rank = 0, c = 0;
+        for (; c < length && rank < rows; ++c) {
+            size_t pivot = rank;
+            while (pivot < rows && h[pivot * length + c] == zero)
+                ++pivot;
+            if (pivot == rows) {
+                informationPositions.push_back(c);
+                continue;
+            }
+            if (pivot != rank)
+                std::swap_ranges(h.begin() + pivot * length,
+                        h.begin() + (pivot + 1) * length,
+                        h.begin() + rank * length);
+            Field const inv = CoefficientTraits<Field>::multInverse(
+                    h[rank * length + c]);
+            for (size_t j = c; j < length; ++j)
+                h[rank * length + j] *= inv;
+            for (size_t i = 0; i < rows; ++i) {
+                Field const x = h[i * length + c];
+                if (i == rank || x == zero)
+                    continue;
+                for (size_t j = c; j < length; ++j)
+                    h[i * length + j] -= x * h[rank * length + j];
+            }
+            parityPositions.push_back(c);
+            ++rank;
+        }
+        for (; c < length; ++c)
+            informationPositions.push_back(c);
+
+        // the i-th parity symbol is minus the i-th row at the information
+        // positions times the message
+        size_t const k = informationPositions.size();
+        parity.reserve(rank * k);
+        for (size_t i = 0; i < rank; ++i)
+            for (size_t f = 0; f < k; ++f)
+                parity.push_back(zero - h[i * length + informationPositions[f]]);
+
+        MV_POLY_LOG(MV_POLY_TRACE_SUMMARY) << "Systematic encoder of ["
+                << length << ", " << k << "] code";
+    }
+
+    Context const & getContext() const {
+        return context;
+    }
+
+    /// Length of the code words (the number of the points).
+    size_t getLength() const {
+        return length;
+    }
+
+    /// Length of the messages.
+    size_t getDimension() const {
+        return informationPositions.size();
+    }
+
+    /// Positions of the code words the messages are written to.
+    std::vector<size_t> const & getInformationPositions() const {
+        return informationPositions;
+    }
+
+    std::vector<size_t> const & getParityPositions() const {
+        return parityPositions;
+    }
+
+    /**
+     * Generator matrix (row-major, getDimension() x getLength()): the rows
+     * are the code words of the unit messages, so it is the identity at
+     * the information positions.
+     */
+    std::vector<Field> getGeneratorMatrix() const {
+        Field const zero = CoefficientTraits<Field>::addId();
+        size_t const k = getDimension();
+        std::vector<Field> result(k * length, zero);
+        for (size_t f = 0; f < k; ++f) {
+            result[f * length + informationPositions[f]] =
+                    CoefficientTraits<Field>::multId();
+            for (size_t i = 0; i < parityPositions.size(); ++i)
+                result[f * length + parityPositions[i]] = parity[i * k + f];
+        }
+        return result;
+    }
+
+    /// Code word of \c message (of getDimension() symbols).
+    FieldElemsCollection encode(FieldElemsCollection const & message) const {
+        return encodeBatch(std::vector<FieldElemsCollection>(1, message)).front();
+    }
+
+    /**
+     * Code words of \c messages: the messages are the columns of a matrix
+     * multiplied by the parity matrix.
+     */
+    std::vector<FieldElemsCollection>
+    encodeBatch(std::vector<FieldElemsCollection> const & messages) const {
+        size_t const k = getDimension();
+        size_t const width = messages.size();
+        std::vector<Field> stacked(k * width);
+        for (size_t w = 0; w < width; ++w) {
+            CHECK(messages[w].size() == k) << "Wrong length of message " << w;
+            for (size_t f = 0; f < k; ++f)
+                stacked[f * width + w] = messages[w][f];
+        }
+        std::vector<Field> const product = multiplyBlocked(
+                parityPositions.size(), k, width, parity, stacked);
+
+        std::vector<FieldElemsCollection> result(width,
+                FieldElemsCollection(length));
+        for (size_t w = 0; w < width; ++w) {
+            for (size_t f = 0; f < k; ++f)
+                result[w][informationPositions[f]] = messages[w][f];
+            for (size_t i = 0; i < parityPositions.size(); ++i)
+                result[w][parityPositions[i]] = product[i * width + w];
+        }
+        return result;
+    }
+
+private:
+    Context const & context;
+
+    size_t const length;
+
+    std::vector<size_t> informationPositions;
+
+    std::vector<size_t> parityPositions;
+
+    /// Parity symbols by the message (row-major, parity x information).
+    std::vector<Field> parity;
+};
+
+} // namespace mv_poly
+
+#endif /* SYSTEMATICENCODER_HPP_ */
@@ -1,17 +1,31 @@
 #include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
 #include <list>
 #include <map>
+#include <numeric>
 #include <iterator>
 #include <string>
 #include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
 
 #include <tr1/array>
 
+#include <unistd.h>
+
 #include <NTL/ZZ_p.h>
 #include <NTL/GF2.h>
 
 #define USE_TR1
 
+// the counters are tested unless they are turned off explicitly
+#ifndef MV_POLY_PERF_COUNTERS
+#define MV_POLY_PERF_COUNTERS 1
+#endif
+
 #include "cute.h"
 #include "ide_listener.h"
 #include "cute_runner.h"
@@ -19,10 +33,20 @@
 #include "mv_poly.hpp"
 #include "Point.hpp"
 #include "bmsa.hpp"
+#include "bmsa-batch.hpp"
 #include "bmsa-decoding.hpp"
+#include "bmsa-decoding-pipeline.hpp"
+#include "SystematicEncoder.hpp"
 #include "NtlUtilities.hpp"
 #include "NtlPolynomials.hpp"
 #include "CurveArithmetic.hpp"
+#include "SequenceView.hpp"
+#include "DenseSequence.hpp"
+#include "Executor.hpp"
+#include "FlatMap.hpp"
+#include "Serialization.hpp"
+#include "TextParser.hpp"
+#include "PolyArchive.hpp"
 
 namespace TestMVPoly {
 
@@ -150,6 +174,63 @@ void pointIncreasing() {
     ASSERT(pt[0] == 1 && pt[1] == 0 && pt[2] == 1);
 }
 
+template<typename Pt>
+std::vector<Pt> incrementedPoints(size_t cnt) {
+    std::vector<Pt> result;
+    result.reserve(cnt);
+    Pt p;
+    for (size_t i = 0; i < cnt; ++i)
+        result.push_back(p++);
+    return result;
+}
+
+template<typename Pt>
+void checkConcurrentIncrement(size_t threadsCnt, size_t pointsCnt) {
+    const std::vector<Pt> reference = incrementedPoints<Pt>(pointsCnt);
+    std::vector< std::vector<Pt> > results(threadsCnt);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < threadsCnt; ++i)
+        threads.push_back(std::thread([&results, i, pointsCnt]() {
+            results[i] = incrementedPoints<Pt>(pointsCnt);
+        }));
+    for (size_t i = 0; i < threadsCnt; ++i)
+        threads[i].join();
+    for (size_t i = 0; i < threadsCnt; ++i)
+        ASSERT(results[i] == reference);
+}
+
+void pointIncreasingWeighted() {
+    typedef Point<2, WeightedOrder<2, 3>::impl> Pt;
+    std::vector<Pt> pts = incrementedPoints<Pt>(8);
+    // weights: 0 2 3 4 5 6 7 8
+    long expected[][2] = {
+            {0, 0}, {1, 0}, {0, 1}, {2, 0}, {1, 1}, {0, 2}, {2, 1}, {1, 2}
+    };
+    for (size_t i = 0; i < pts.size(); ++i)
+        ASSERT(pts[i][0] == expected[i][0] && pts[i][1] == expected[i][1]);
+
+    // the whole plane, x^3 > y^2
+    typedef Point<2, WeightedMonomialOrder<2, 3>::impl> LPt;
+    std::vector<LPt> lpts = incrementedPoints<LPt>(10);
+    long lexpected[][2] = {
+            {0, 0}, {1, 0}, {0, 1}, {2, 0}, {1, 1}, {0, 2}, {3, 0}, {2, 1},
+            {1, 2}, {4, 0}
+    };
+    for (size_t i = 0; i < lpts.size(); ++i) {
+        ASSERT(lpts[i][0] == lexpected[i][0] && lpts[i][1] == lexpected[i][1]);
+        ASSERT(i == 0 || lpts[i - 1] < lpts[i]);
+    }
+}
+
+// stress test: order policies must not share any mutable state
+void pointIncreasingConcurrently() {
+    const size_t threadsCnt = 8;
+    checkConcurrentIncrement< Point<2, WeightedOrder<2, 3>::impl> >(threadsCnt, 2000);
+    checkConcurrentIncrement< Point<2, WeightedOrder<4, 5>::impl> >(threadsCnt, 2000);
+    checkConcurrentIncrement< Point<2> >(threadsCnt, 2000);
+    checkConcurrentIncrement< Point<3> >(threadsCnt, 2000);
+}
+
 void pointCollectionOperations() {
     Point<2> pt;
     std::list<Point<2> > s, sn, sig;
@@ -225,6 +306,70 @@ void convolutionTest() {
     ASSERT_EQUAL(1, conv(f, u, degf, m));
 }
 
+template<int Dim, template<typename> class Order>
+void checkSupportRestrictedConvolution(
+        string const & seqStr,
+        std::vector<string> const & polyStrs,
+        int pointCnt,
+        bool withMaps = true) {
+    typedef typename MVPolyType<Dim, NTL::ZZ_p>::type PolyT;
+    typedef Point<Dim, Order> Pt;
+    PolyT u(seqStr);
+    DenseSequence<Dim, NTL::ZZ_p, Order> uView(u);
+
+    std::map<Pt, NTL::ZZ_p> uMap;
+    forEachCoefficient<Pt>(u, [&uMap](Pt const & pt, NTL::ZZ_p const & c) {
+        uMap[pt] = c;
+    });
+    DenseSequence<Dim, NTL::ZZ_p, Order> uMapView(uMap);
+
+    Pt upper;
+    for (int i = 0; i < pointCnt; ++i)
+        ++upper;
+    for (size_t n = 0; n < polyStrs.size(); ++n) {
+        PolyT f(polyStrs[n]);
+        for (Pt degf; degf < upper; ++degf) {
+            SupportTerms<Pt, NTL::ZZ_p> const terms(f, degf);
+            for (Pt m(degf); m < upper; ++m) {
+                if (!byCoordinateLess(degf, m))
+                    continue;
+                NTL::ZZ_p ref = conv(f, u, degf, m);
+                ASSERT_EQUAL(ref, convSupport(f, uView, degf, m));
+                ASSERT_EQUAL(ref, convSupport(terms, uView, degf, m));
+                if (!withMaps)
+                    continue;
+                std::map<Pt, NTL::ZZ_p> uMapCopy(uMap);
+                ASSERT_EQUAL(ref, conv(f, uMapCopy, degf, m));
+                ASSERT_EQUAL(ref, convSupport(terms, uMapView, degf, m));
+            }
+        }
+    }
+}
+
+void convolutionSupportRestricted() {
+    NTL::ZZ_p::init(NTL::to_ZZ(7));
+    std::vector<string> polys2;
+    polys2.push_back("[[1 1] [1]]");
+    polys2.push_back("[[0 3 0 5] [2] [0 0 6] [1]]");
+    polys2.push_back("[[4]]");
+    checkSupportRestrictedConvolution<2, GradedAntilexMonomialOrder>(
+            "[[0 1 0 1 0 3] [1 1 6 0] [0 1 0] [2 4] [0] [1 5 5]]", polys2, 28);
+    // terms with x >= 3 are not enumerated by the weighted order (and
+    // can't be keys of a map ordered by it)
+    polys2.push_back("[[1 1] [0 1] [1] [1 0 1]]");
+    checkSupportRestrictedConvolution<2, WeightedOrder<2, 3>::impl>(
+            "[[0 1 0 1 0 3] [1 1 6 0] [0 1 0] [2 4] [0] [1 5 5]]", polys2, 20,
+            false);
+    std::vector<string> polys3;
+    polys3.push_back("[[[1 1] [1]] [[0]] [[1]]]");
+    polys3.push_back("[[[0 1] [0 1] [0]] [[0 0] [3]] [[1]]]");
+    checkSupportRestrictedConvolution<3, GradedAntilexMonomialOrder>(
+            "[[[1 1 1 1 0 0] [0 1 0 1 0] [1 1 0 0]] [[1 1 0 1 1] [1 0 1 1]]"
+            " [[0 1 0 0] [0 0 1]] [[1 1 0] [1 0] [0] [1]] [[1 1] [0] [1]]]",
+            polys3, 35);
+    NTL::ZZ_p::init(NTL::to_ZZ(2));
+}
+
 void scalarMultiplication() {
     MVPolyType<2, int>::ResultT p("[[1 0 1] [1 1]]");
     p *= 2;
@@ -260,6 +405,11 @@ void summation() {
 void equality() {
     MVPolyType<2, int>::ResultT p, q("[[0 0] [0]]");
     ASSERT_EQUAL(p, q);
+    // comparison strips trailing zeros only
+    typedef MVPolyType<2, int>::ResultT PolyT;
+    PolyT r("[[1 0 1] [1 1] [0 0]]"), s("[[1 0 1] [1 1]]");
+    ASSERT_EQUAL(r, s);
+    ASSERT_EQUAL(PolyT("[[1 0 1] [1 1]]"), r);
 }
 
 void eval() {
@@ -272,6 +422,52 @@ void eval() {
     ASSERT_EQUAL(8, p1(pt));
 }
 
+template<int Dim>
+void checkUnrolledKernels(string const & polyStr, std::vector<int> const & cp) {
+    typedef typename MVPolyType<Dim, int>::type PolyT;
+    typedef Point<Dim> Pt;
+    PolyT p(polyStr);
+    Pt upper;
+    upper[0] = 7;
+    for (Pt i; i < upper; ++i) {
+        ASSERT_EQUAL(
+                GenericPolyKernels<Dim>::subscript(p, i),
+                PolyKernels<Dim>::subscript(p, i));
+        PolyT q1(p), q2(p);
+        GenericPolyKernels<Dim>::shift(q1, i);
+        PolyKernels<Dim>::shift(q2, i);
+        ASSERT_EQUAL(toString(q1), toString(q2));
+
+        Pt j(i);
+        ++j;
+        std::array<long, Dim> li, lj;
+        for (int d = 0; d < Dim; ++d) {
+            li[d] = i[d];
+            lj[d] = j[d];
+        }
+        ASSERT_EQUAL(
+                GenericCoordinateKernels<Dim>::lessEqual(li, lj),
+                CoordinateKernels<Dim>::lessEqual(li, lj));
+        ASSERT_EQUAL(
+                GenericCoordinateKernels<Dim>::gradedAntilexLess(li, lj),
+                CoordinateKernels<Dim>::gradedAntilexLess(li, lj));
+        std::array<long, Dim> gi(li), si(li);
+        GenericCoordinateKernels<Dim>::gradedAntilexInc(gi);
+        CoordinateKernels<Dim>::gradedAntilexInc(si);
+        ASSERT(gi == si);
+    }
+    ASSERT_EQUAL(
+            GenericPolyKernels<Dim>::eval(p, cp),
+            PolyKernels<Dim>::eval(p, cp));
+}
+
+void unrolledKernels() {
+    std::vector<int> cp(3);
+    cp[0] = 2; cp[1] = 3; cp[2] = 5;
+    checkUnrolledKernels<2>("[[1 2 3] [0 4] [5] [1 0 0 7]]", cp);
+    checkUnrolledKernels<3>("[[[1 2] [3]] [[3] [2 1]] [[1]] [[0 0 4] [1]]]", cp);
+}
+
 void sakatasExample2D() {
     ostringstream os;
     typedef MVPolyType<2, NTL::GF2>::ResultT PolyT;
@@ -287,6 +483,427 @@ void sakatasExample2D() {
             "[[1 1] [1 0] [0] [1]]\n", os.str());
 }
 
+void sakatasExamplesDenseSequence() {
+    typedef MVPolyType<2, NTL::GF2>::ResultT PolyT;
+    PolyT u("[[0 1 0 1 0] [1 1 0 0] [0 1 0] [0 0] [0] [1]]");
+    DenseSequence<2, NTL::GF2> du(u);
+    Point<2> pt;
+    pt[0] = 4; pt[1] = 1;
+    BMSAlgorithm< PolyT > alg(u, pt);
+    BMSAlgorithm< DenseSequence<2, NTL::GF2>, PolyT > denseAlg(du, pt);
+    ASSERT(alg.computeMinimalSet() == denseAlg.computeMinimalSet());
+
+    typedef MVPolyType<3, NTL::GF2>::ResultT PolyT3;
+    PolyT3 v(
+            "[[[1 1 1 1 0 0] [0 1 0 1 0] [1 1 0 0] [0 1 0] [0 0] [0] [1]]"
+            "[[1 1 0 1 1] [1 0 1 1] [0 1 1] [1 1] [1] [0]]"
+            "[[0 1 0 0] [0 0 1] [0 0] [1] [0]]"
+            "[[1 1 0] [1 0] [0] [1]] [[1 1] [0] [1]] [[1] [1]] [[0]]]"
+            );
+    DenseSequence<3, NTL::GF2> dv(v);
+    Point<3> ptt;
+    ptt[0] = 5; ptt[1] = 0; ptt[2] = 1;
+    BMSAlgorithm< PolyT3 > alg3(v, ptt);
+    BMSAlgorithm< DenseSequence<3, NTL::GF2>, PolyT3 > denseAlg3(dv, ptt);
+    ASSERT(alg3.computeMinimalSet() == denseAlg3.computeMinimalSet());
+}
+
+void sakatasExamplesSupportCaching() {
+    typedef MVPolyType<2, NTL::GF2>::ResultT PolyT;
+    PolyT u("[[0 1 0 1 0] [1 1 0 0] [0 1 0] [0 0] [0] [1]]");
+    DenseSequence<2, NTL::GF2> du(u);
+    Point<2> pt;
+    pt[0] = 4; pt[1] = 1;
+    BMSAlgorithm< PolyT > alg(u, pt);
+    BMSAlgorithm< PolyT > incAlg(u, pt);
+    incAlg.setSupportCaching(true);
+    BMSAlgorithm< DenseSequence<2, NTL::GF2>, PolyT > denseIncAlg(du, pt);
+    denseIncAlg.setSupportCaching(true);
+    BMSAlgorithm< PolyT >::PolynomialCollection minset = alg.computeMinimalSet();
+    ASSERT(minset == incAlg.computeMinimalSet());
+    ASSERT(minset == denseIncAlg.computeMinimalSet());
+    ASSERT(alg.getF() == incAlg.getF());
+#if MV_POLY_PERF_COUNTERS
+    BmsaCounters const & counters = incAlg.getPerfCounters().getTotal();
+    ASSERT(counters.reusedSupportUses > 0);
+    ASSERT(counters.shiftedSupports > 0);
+    ASSERT_EQUAL(0ul, alg.getPerfCounters().getTotal().reusedSupportUses);
+    ASSERT_EQUAL(counters.reusedSupportUses,
+            denseIncAlg.getPerfCounters().getTotal().reusedSupportUses);
+#endif
+
+    typedef MVPolyType<3, NTL::GF2>::ResultT PolyT3;
+    PolyT3 v(
+            "[[[1 1 1 1 0 0] [0 1 0 1 0] [1 1 0 0] [0 1 0] [0 0] [0] [1]]"
+            "[[1 1 0 1 1] [1 0 1 1] [0 1 1] [1 1] [1] [0]]"
+            "[[0 1 0 0] [0 0 1] [0 0] [1] [0]]"
+            "[[1 1 0] [1 0] [0] [1]] [[1 1] [0] [1]] [[1] [1]] [[0]]]"
+            );
+    Point<3> ptt;
+    ptt[0] = 5; ptt[1] = 0; ptt[2] = 1;
+    BMSAlgorithm< PolyT3 > alg3(v, ptt);
+    BMSAlgorithm< PolyT3 > incAlg3(v, ptt);
+    incAlg3.setSupportCaching(true);
+    ASSERT(alg3.computeMinimalSet() == incAlg3.computeMinimalSet());
+#if MV_POLY_PERF_COUNTERS
+    ASSERT(incAlg3.getPerfCounters().getTotal().reusedSupportUses > 0);
+#endif
+}
+
+void flatMapOperations() {
+    FlatMap< Point<2>, string > m;
+    Point<2> a = {1, 0}, b = {0, 2}, c = {3, 0};
+    m[c] = "c";
+    m[a] = "a";
+    ASSERT(m.insert(std::make_pair(b, string("b"))).second);
+    ASSERT(!m.insert(std::make_pair(b, string("bb"))).second);
+    ASSERT_EQUAL(3u, m.size());
+    FlatMap< Point<2>, string >::const_iterator it = m.begin();
+    ASSERT_EQUAL(a, it->first);
+    ASSERT_EQUAL("b", (++it)->second);
+    ASSERT_EQUAL(c, (++it)->first);
+    ASSERT(m.find(Point<2>()) == m.end());
+    ASSERT_EQUAL("c", m.find(c)->second);
+
+    FlatMap< Point<2>, string > n;
+    n.push_back(a, "a");
+    n.push_back(c, "c");
+    n.push_back(b, "b"); // out of order
+    ASSERT(m == n);
+    n.swap(m);
+    m.clear();
+    ASSERT(m.empty());
+    ASSERT_EQUAL(3u, n.size());
+}
+
+void workStealingPool() {
+    WorkStealingPool pool(4);
+    std::vector<long> squares(1000);
+    pool.parallelFor(squares.size(), [&squares](size_t i) {
+        squares[i] = i * i;
+    });
+    for (size_t i = 0; i < squares.size(); ++i)
+        ASSERT_EQUAL(long(i * i), squares[i]);
+
+    // nested loops are run by the same pool
+    std::vector<long> sums(8);
+    pool.parallelFor(sums.size(), [&pool, &sums](size_t i) {
+        std::vector<long> parts(100);
+        pool.parallelFor(parts.size(), [&parts, i](size_t j) {
+            parts[j] = i + j;
+        });
+        sums[i] = std::accumulate(parts.begin(), parts.end(), 0l);
+    });
+    for (size_t i = 0; i < sums.size(); ++i)
+        ASSERT_EQUAL(long(100 * i + 4950), sums[i]);
+
+    bool thrown = false;
+    try {
+        pool.parallelFor(10, [](size_t i) {
+            if (i == 7)
+                throw std::runtime_error("task failed");
+        });
+    } catch (std::runtime_error const &) {
+        thrown = true;
+    }
+    ASSERT(thrown);
+}
+
+template<typename PolyT, typename SeqT>
+void checkParallelBmsa(SeqT & u, typename BMSAlgorithm<PolyT>::PointT const & len) {
+    WorkStealingPool pool(4);
+    BMSAlgorithm< SeqT, PolyT > alg(u, len);
+    BMSAlgorithm< SeqT, PolyT > parAlg(u, len, &pool);
+    BMSAlgorithm< SeqT, PolyT > parIncAlg(u, len);
+    parIncAlg.setExecutor(&pool);
+    parIncAlg.setSupportCaching(true);
+    typename BMSAlgorithm< SeqT, PolyT >::PolynomialCollection minset =
+            alg.computeMinimalSet();
+    ASSERT(minset == parAlg.computeMinimalSet());
+    ASSERT(minset == parIncAlg.computeMinimalSet());
+    ASSERT(alg.getF() == parAlg.getF());
+    ASSERT(alg.getDeltaPoints() == parIncAlg.getDeltaPoints());
+}
+
+void sakatasExamplesParallel() {
+    typedef MVPolyType<2, NTL::GF2>::ResultT PolyT;
+    PolyT u("[[0 1 0 1 0] [1 1 0 0] [0 1 0] [0 0] [0] [1]]");
+    Point<2> pt;
+    pt[0] = 4; pt[1] = 1;
+    checkParallelBmsa<PolyT>(u, pt);
+    std::map<Point<2>, NTL::GF2> uMap;
+    forEachCoefficient< Point<2> >(u,
+            [&uMap](Point<2> const & p, NTL::GF2 const & c) { uMap[p] = c; });
+    checkParallelBmsa<PolyT>(uMap, pt);
+
+    typedef MVPolyType<3, NTL::GF2>::ResultT PolyT3;
+    PolyT3 v(
+            "[[[1 1 1 1 0 0] [0 1 0 1 0] [1 1 0 0] [0 1 0] [0 0] [0] [1]]"
+            "[[1 1 0 1 1] [1 0 1 1] [0 1 1] [1 1] [1] [0]]"
+            "[[0 1 0 0] [0 0 1] [0 0] [1] [0]]"
+            "[[1 1 0] [1 0] [0] [1]] [[1 1] [0] [1]] [[1] [1]] [[0]]]"
+            );
+    DenseSequence<3, NTL::GF2> dv(v);
+    Point<3> ptt;
+    ptt[0] = 5; ptt[1] = 0; ptt[2] = 1;
+    checkParallelBmsa<PolyT3>(v, ptt);
+    checkParallelBmsa<PolyT3>(dv, ptt);
+}
+
+template<typename PolyT, typename SeqT>
+void checkStreamingBmsa(
+        PolyT const & u,
+        typename BMSAlgorithm<PolyT>::PointT const & len,
+        bool cachingSupports) {
+    typedef BMSAlgorithm< SeqT, PolyT > StreamingBmsaT;
+    typedef typename StreamingBmsaT::PointT PointT;
+    PolyT uCopy(u);
+    BMSAlgorithm< PolyT > alg(uCopy, len);
+    typename StreamingBmsaT::PolynomialCollection minset = alg.computeMinimalSet();
+
+    SeqT seq;
+    StreamingBmsaT streaming(seq, PointT());
+    streaming.setSupportCaching(cachingSupports);
+    ASSERT_EQUAL(PointT(), streaming.nextPoint());
+    ASSERT_EQUAL(1u, streaming.current().size());
+    while (streaming.nextPoint() < len)
+        streaming.step(u[streaming.nextPoint()]);
+    ASSERT(minset == streaming.current());
+    ASSERT(alg.getF() == streaming.getF());
+    ASSERT_EQUAL(len, streaming.getSeqLen());
+
+    // batch computation resumes after steps
+    SeqT seq2;
+    StreamingBmsaT resumed(seq2, PointT());
+    resumed.setSupportCaching(cachingSupports);
+    PointT half;
+    for (int i = 0; i < 7; ++i, ++half)
+        resumed.step(u[half]);
+    for (PointT pt(half); pt < len; ++pt)
+        setSequenceElement(seq2, pt, u[pt]);
+    resumed.getSeqLen() = len;
+    ASSERT(minset == resumed.computeMinimalSet());
+    ASSERT_EQUAL(len, resumed.nextPoint());
+}
+
+void sakatasExamplesStreaming() {
+    typedef MVPolyType<2, NTL::GF2>::ResultT PolyT;
+    PolyT u("[[0 1 0 1 0] [1 1 0 0] [0 1 0] [0 0] [0] [1]]");
+    Point<2> pt;
+    pt[0] = 4; pt[1] = 1;
+    checkStreamingBmsa< PolyT, PolyT >(u, pt, false);
+    checkStreamingBmsa< PolyT, std::map<Point<2>, NTL::GF2> >(u, pt, false);
+    checkStreamingBmsa< PolyT, std::map<Point<2>, NTL::GF2> >(u, pt, true);
+    checkStreamingBmsa< PolyT, DenseSequence<2, NTL::GF2> >(u, pt, true);
+
+    typedef MVPolyType<3, NTL::GF2>::ResultT PolyT3;
+    PolyT3 v(
+            "[[[1 1 1 1 0 0] [0 1 0 1 0] [1 1 0 0] [0 1 0] [0 0] [0] [1]]"
+            "[[1 1 0 1 1] [1 0 1 1] [0 1 1] [1 1] [1] [0]]"
+            "[[0 1 0 0] [0 0 1] [0 0] [1] [0]]"
+            "[[1 1 0] [1 0] [0] [1]] [[1 1] [0] [1]] [[1] [1]] [[0]]]"
+            );
+    Point<3> ptt;
+    ptt[0] = 5; ptt[1] = 0; ptt[2] = 1;
+    checkStreamingBmsa< PolyT3, PolyT3 >(v, ptt, true);
+    checkStreamingBmsa< PolyT3, DenseSequence<3, NTL::GF2> >(v, ptt, false);
+}
+
+void sakatasExamplesCheckpoint() {
+    typedef MVPolyType<3, NTL::GF2>::ResultT PolyT3;
+    PolyT3 v(
+            "[[[1 1 1 1 0 0] [0 1 0 1 0] [1 1 0 0] [0 1 0] [0 0] [0] [1]]"
+            "[[1 1 0 1 1] [1 0 1 1] [0 1 1] [1 1] [1] [0]]"
+            "[[0 1 0 0] [0 0 1] [0 0] [1] [0]]"
+            "[[1 1 0] [1 0] [0] [1]] [[1 1] [0] [1]] [[1] [1]] [[0]]]"
+            );
+    Point<3> ptt;
+    ptt[0] = 5; ptt[1] = 0; ptt[2] = 1;
+    BMSAlgorithm< PolyT3 > alg(v, ptt);
+    BMSAlgorithm< PolyT3 >::PolynomialCollection minset = alg.computeMinimalSet();
+
+    // checkpoint on a prefix, resumed on the whole sequence
+    Point<3> half;
+    half[0] = 3;
+    BMSAlgorithm< PolyT3 > prefixAlg(v, half);
+    prefixAlg.computeMinimalSet();
+    std::ostringstream checkpoint;
+    prefixAlg.saveCheckpoint(checkpoint);
+
+    BMSAlgorithm< PolyT3 > resumed(v, Point<3>());
+    std::istringstream is(checkpoint.str());
+    resumed.restoreCheckpoint(is);
+    ASSERT_EQUAL(half, resumed.nextPoint());
+    ASSERT(prefixAlg.getF() == resumed.getF());
+    ASSERT(prefixAlg.getDeltaPoints() == resumed.getDeltaPoints());
+    resumed.getSeqLen() = ptt;
+    resumed.setSupportCaching(true);
+    ASSERT(minset == resumed.computeMinimalSet());
+    ASSERT(alg.getF() == resumed.getF());
+
+    // the checkpoint doesn't fit other sequence
+    PolyT3 w(v);
+    Point<3> changed;
+    changed[2] = 1;
+    setCoefficient(w, changed, NTL::GF2(0));
+    BMSAlgorithm< PolyT3 > other(w, ptt);
+    std::istringstream is2(checkpoint.str());
+    bool thrown = false;
+    try {
+        other.restoreCheckpoint(is2);
+    } catch (std::runtime_error const &) {
+        thrown = true;
+    }
+    ASSERT(thrown);
+    ASSERT_EQUAL(Point<3>(), other.nextPoint());
+}
+
+void sakatasExampleTraced() {
+    typedef MVPolyType<2, NTL::GF2>::ResultT PolyT;
+    typedef BMSAlgorithm< PolyT > BmsaT;
+    PolyT u("[[0 1 0 1 0] [1 1 0 0] [0 1 0] [0 0] [0] [1]]");
+    Point<2> pt;
+    pt[0] = 4; pt[1] = 1;
+    BmsaT alg(u, pt);
+    std::vector<BmsaT::StepTrace> steps;
+    alg.setTraceSink([&steps](BmsaT::StepTrace const & step) {
+        steps.push_back(step);
+    });
+    alg.computeMinimalSet();
+
+    ASSERT_EQUAL(16u, steps.size());
+    Point<2> k;
+    for (size_t i = 0; i < steps.size(); ++i, ++k) {
+        ASSERT_EQUAL(k, steps[i].k);
+        ASSERT(steps[i].nonzeroCnt <= steps[i].spanningCnt);
+        ASSERT(steps[i].berlekampCnt <= steps[i].sigmaPoints.size());
+    }
+    ASSERT(alg.getDeltaPoints() == steps.back().deltaPoints);
+    BmsaT::PointCollection degs;
+    for (BmsaT::PointPolyMap::const_iterator it = alg.getF().begin();
+            it != alg.getF().end(); ++it)
+        degs.push_back(it->first);
+    BmsaT::PointCollection sigma(steps.back().sigmaPoints);
+    std::sort(sigma.begin(), sigma.end());
+    ASSERT(degs == sigma);
+}
+
+#if MV_POLY_PERF_COUNTERS
+void sakatasExamplePerfCounters() {
+    typedef MVPolyType<2, NTL::GF2>::ResultT PolyT;
+    typedef BMSAlgorithm< PolyT > BmsaT;
+    PolyT u("[[0 1 0 1 0] [1 1 0 0] [0 1 0] [0 0] [0] [1]]");
+    Point<2> pt;
+    pt[0] = 4; pt[1] = 1;
+    BmsaT alg(u, pt), incAlg(u, pt);
+    alg.setCounterStepsRecorded(true);
+    incAlg.setSupportCaching(true);
+    std::vector<BmsaT::StepTrace> steps;
+    alg.setTraceSink([&steps](BmsaT::StepTrace const & step) {
+        steps.push_back(step);
+    });
+    alg.computeMinimalSet();
+    incAlg.computeMinimalSet();
+
+    BmsaPerfCounters<Point<2> > const & perf = alg.getPerfCounters();
+    ASSERT_EQUAL(steps.size(), perf.getSteps().size());
+    unsigned long convolutions = 0, nonzero = 0, berlekamp = 0;
+    for (size_t i = 0; i < steps.size(); ++i) {
+        BmsaCounters const & c = perf.getSteps()[i].second;
+        ASSERT_EQUAL(steps[i].k, perf.getSteps()[i].first);
+        ASSERT_EQUAL(steps[i].spanningCnt, c.convolutions);
+        ASSERT_EQUAL(steps[i].nonzeroCnt, c.nonzeroDiscrepancies);
+        ASSERT_EQUAL(steps[i].berlekampCnt, c.berlekampUpdates);
+        ASSERT_EQUAL(steps[i].sigmaPoints.size(), c.berlekampUpdates + c.degBumps);
+        ASSERT_EQUAL(steps[i].deltaPoints.size(), c.deltaSize);
+        convolutions += c.convolutions;
+        nonzero += c.nonzeroDiscrepancies;
+        berlekamp += c.berlekampUpdates;
+    }
+    BmsaCounters const & total = perf.getTotal();
+    ASSERT_EQUAL(convolutions, total.convolutions);
+    ASSERT_EQUAL(nonzero, total.nonzeroDiscrepancies);
+    ASSERT_EQUAL(berlekamp, total.berlekampUpdates);
+    ASSERT(total.fieldMults >= total.convolutionTerms);
+    ASSERT(total.fieldInversions > 0);
+    // the same sums are computed over the cached supports
+    ASSERT_EQUAL(total.convolutions, incAlg.getPerfCounters().getTotal().convolutions);
+    ASSERT_EQUAL(total.convolutionTerms,
+            incAlg.getPerfCounters().getTotal().convolutionTerms);
+    // only the totals unless the steps are recorded
+    ASSERT(incAlg.getPerfCounters().getSteps().empty());
+
+    std::ostringstream os;
+    alg.writeCountersJson(os);
+    string const json = os.str();
+    ASSERT_EQUAL(0u, json.find("{\"total\": {\"convolutions\": "));
+    ASSERT(json.find("\"steps\": [{\"k\": [0, 0], \"counters\": {") != string::npos);
+    ASSERT_EQUAL(std::count(json.begin(), json.end(), '{'),
+            std::count(json.begin(), json.end(), '}'));
+    alg.resetCounters();
+    ASSERT(alg.getPerfCounters().getSteps().empty());
+    os.str("");
+    incAlg.writeCountersJson(os);
+    ASSERT_EQUAL(string::npos, os.str().find("\"steps\""));
+}
+#endif
+
+template<int Dim, typename PolyT>
+void checkBatchedBmsa(
+        std::vector<PolyT> const & seqs,
+        Point<Dim> const & len,
+        size_t subBatchCnt) {
+    BatchedBMSAlgorithm<Dim, typename PolyT::CoefT> batched(seqs, len);
+    std::vector< typename BMSAlgorithm<PolyT>::PolynomialCollection > minsets =
+            batched.computeMinimalSets();
+    ASSERT_EQUAL(seqs.size(), minsets.size());
+    for (size_t i = 0; i < seqs.size(); ++i) {
+        PolyT u(seqs[i]);
+        BMSAlgorithm<PolyT> alg(u, len);
+        ASSERT(alg.computeMinimalSet() == minsets[i]);
+    }
+    ASSERT_EQUAL(subBatchCnt, batched.getSubBatchCnt());
+    ASSERT_EQUAL(subBatchCnt - 1, batched.getSplitCnt() - batched.getMergeCnt());
+}
+
+void sakatasExamplesBatched() {
+    typedef MVPolyType<2, NTL::GF2>::ResultT PolyT;
+    PolyT u("[[0 1 0 1 0] [1 1 0 0] [0 1 0] [0 0] [0] [1]]");
+    Point<2> pt;
+    pt[0] = 4; pt[1] = 1;
+    std::vector<PolyT> same(3, u);
+    checkBatchedBmsa(same, pt, 1);
+
+    std::vector<PolyT> diverged(same);
+    diverged.push_back(PolyT("[[0 1 0 1 0] [1 1 0 0] [0 1 1] [0 0] [0] [1]]"));
+    diverged.push_back(PolyT("[[1 0 0 0 0] [0 0 0 0] [0 0 0] [0 0] [0] [0]]"));
+    diverged.push_back(PolyT("[[0]]"));
+    diverged.push_back(u);
+    checkBatchedBmsa(diverged, pt, 4);
+
+    // the staircases diverge and meet again: the sub-batches are merged
+    std::vector<PolyT> met;
+    met.push_back(u);
+    met.push_back(PolyT("[[0 1 1 1 1] [0 0 0 1] [0 1 0] [1 0] [0] [0]]"));
+    BatchedBMSAlgorithm<2, NTL::GF2> metBatch(met, pt);
+    metBatch.computeMinimalSets();
+    ASSERT(metBatch.getMergeCnt() > 0);
+    checkBatchedBmsa(met, pt, 1);
+
+    typedef MVPolyType<3, NTL::GF2>::ResultT PolyT3;
+    std::vector<PolyT3> seqs3;
+    seqs3.push_back(PolyT3(
+            "[[[1 1 1 1 0 0] [0 1 0 1 0] [1 1 0 0] [0 1 0] [0 0] [0] [1]]"
+            "[[1 1 0 1 1] [1 0 1 1] [0 1 1] [1 1] [1] [0]]"
+            "[[0 1 0 0] [0 0 1] [0 0] [1] [0]]"
+            "[[1 1 0] [1 0] [0] [1]] [[1 1] [0] [1]] [[1] [1]] [[0]]]"
+            ));
+    seqs3.push_back(seqs3.back());
+    Point<3> ptt;
+    ptt[0] = 5; ptt[1] = 0; ptt[2] = 1;
+    checkBatchedBmsa(seqs3, ptt, 1);
+}
+
 void sakatasExample3D() {
     ostringstream os;
     Point<3> ptt;
@@ -313,6 +930,35 @@ void sakatasExample3D() {
             os.str());
 }
 
+void denseSequence() {
+    typedef MVPolyType<2, int>::type PolyT;
+    PolyT u("[[0 1 0 1 0] [1 1 0 0] [0 1 0] [0 0] [0] [1]]");
+    DenseSequence<2, int> fromPoly(u), appended;
+    Point<2> upper;
+    upper[0] = 7;
+    for (Point<2> pt; pt < upper; ++pt) {
+        ASSERT_EQUAL(u[pt], fromPoly[pt]);
+        appended.push_back(u[pt]);
+        ASSERT(pt < appended.getEnd());
+        ASSERT_EQUAL(u[pt], appended[pt]);
+    }
+    for (Point<2> pt; pt < upper; ++pt)
+        ASSERT_EQUAL(u[pt], appended[pt]);
+    ASSERT(upper == appended.getEnd());
+
+    typedef Point<2, WeightedOrder<2, 3>::impl> WPt;
+    DenseSequence<2, int, WeightedOrder<2, 3>::impl> weighted;
+    weighted.push_back(1);
+    weighted.push_back(2);
+    weighted.push_back(3);
+    WPt pt;
+    ASSERT_EQUAL("(0, 0) : 1 (1, 0) : 2 (0, 1) : 3 ", mapToStr(weighted));
+    pt[0] = 1; pt[1] = 0;
+    ASSERT_EQUAL(2, weighted[pt]);
+    pt[0] = 5; pt[1] = 5;
+    ASSERT_EQUAL(0, weighted[pt]);
+}
+
 void testPolyToDegCoefMapConversion() {
     using namespace std;
     Polynomial<int> p;
@@ -337,6 +983,80 @@ void testPolyToDegCoefMapConversion() {
             os.str());
 }
 
+// the lazy ranges yield the nonzero terms: in storage order and sorted
+void nonzeroTermRanges() {
+    typedef MVPolyType<3, int>::type PolyT;
+    typedef Point<3> Pt;
+    PolyT const p("[[[0 1] [0] [2 0 3]] [[0]] [[4] [0 0 0 5]] [[0 6]]]");
+
+    std::vector< std::pair<Pt, int> > stored;
+    forEachCoefficient<Pt>(p, [&stored](Pt const & pt, int c) {
+        if (c != 0)
+            stored.push_back(std::make_pair(pt, c));
+    });
+    std::vector< std::pair<Pt, int> > terms;
+    for (auto const & term : nonzeroTerms(p))
+        terms.push_back(std::make_pair(term.getPoint(), term.getCoef()));
+    ASSERT_EQUAL(6u, terms.size());
+    ASSERT(stored == terms);
+
+    std::sort(stored.begin(), stored.end());
+    terms.clear();
+    for (auto const & term : orderedTerms<GradedAntilexMonomialOrder>(p))
+        terms.push_back(std::make_pair(term.getPoint(), term.getCoef()));
+    ASSERT(stored == terms);
+
+    ASSERT(boost::empty(nonzeroTerms(PolyT("[[[0]] [[0 0]]]"))));
+    ASSERT(boost::empty(orderedTerms<GradedAntilexMonomialOrder>(PolyT())));
+
+    // the order of the code lattice of a Hermitian curve (weights 4, 5)
+    typedef WeightedMonomialOrder<4, 5> Weighted;
+    typedef Point<2, Weighted::impl> WPt;
+    MVPolyType<2, int>::type const q("[[1 0 2 3] [4] [0 5 0 6] [7 8]]");
+    std::vector<WPt> points;
+    for (auto const & term : orderedTerms<Weighted::impl>(q))
+        points.push_back(term.getPoint());
+    ASSERT_EQUAL(8u, points.size());
+    ASSERT(std::is_sorted(points.begin(), points.end()));
+}
+
+// the constructors agree with the text format
+void directConstruction() {
+    typedef MVPolyType<3, int>::type PolyT;
+    ASSERT_EQUAL(PolyT("[[[1]]]"), PolyT::identity());
+    ASSERT_EQUAL(PolyT("[[[0]]]"), PolyT::zero());
+    ASSERT_EQUAL(&PolyT::identity(), &PolyT::identity());
+    ASSERT_EQUAL(PolyT::identity(), PolyT::getId());
+
+    Point<3> m;
+    m[0] = 1; m[1] = 0; m[2] = 2;
+    ASSERT_EQUAL(PolyT("[[[0]] [[0 0 5]]]"), PolyT::monomial(m, 5));
+    ASSERT_EQUAL(PolyT("[[[0]] [[0 0 1]]]"), PolyT::monomial(m));
+
+    std::array<long, 3> extents = {{ 2, 3, 2 }};
+    int const dense[] = { 1, 2,  0, 0,  3, 0,    0, 4,  5, 6,  0, 0 };
+    PolyT const p = from_dense<PolyT>(dense, extents);
+    ASSERT_EQUAL(PolyT("[[[1 2] [0 0] [3]] [[0 4] [5 6]]]"), p);
+    ASSERT_EQUAL(p, from_dense<PolyT>(std::vector<int>(dense, dense + 12), extents));
+    extents[1] = 0;
+    ASSERT_EQUAL(PolyT::zero(), from_dense<PolyT>(dense, extents));
+
+    ASSERT_EQUAL(p, from_terms<PolyT>(nonzeroTerms(p)));
+    ASSERT_EQUAL(p, from_terms<PolyT>(polyToDegCoefMap<GradedAntilexMonomialOrder>(p)));
+    ASSERT_EQUAL(PolyT::zero(), from_terms<PolyT>(nonzeroTerms(PolyT::zero())));
+
+    typedef MVPolyType<2, int>::type Poly2T;
+    int const row0[] = { 1, 2 }, row2[] = { 3 };
+    int const * rows[] = { row0, row0, row2 };
+    size_t lens[] = { 2, 0, 1 };
+    ASSERT_EQUAL(Poly2T("[[1 2] [0] [3]]"), load_coefs<Poly2T>(rows, 3, lens));
+
+    typedef NTLPrimeFieldTtraits<NTL::GF2>::ExtField ExtField;
+    initExtendedField<NTL::GF2>("[1 1 0 0 1]");
+    typedef MVPolyType<2, ExtField>::type PolyE;
+    ASSERT_EQUAL(PolyE("[[[1]]]"), PolyE::identity());
+}
+
 void polyPowerPrinting() {
     typedef NTL::GF2 PrimeField;
     typedef typename NTLPrimeFieldTtraits<PrimeField>::ExtField ExtField;
@@ -360,6 +1080,214 @@ void polyPowerPrinting() {
             os.str());
 }
 
+template<typename PolyT>
+void checkBinaryRoundTrip(PolyT const & p) {
+    std::ostringstream os;
+    writeBinary(os, p);
+    std::istringstream is(os.str());
+    PolyT q;
+    readBinary(is, q);
+    ASSERT_EQUAL(p, q);
+    ASSERT_EQUAL(std::char_traits<char>::eof(), is.peek());
+}
+
+void polyBinaryIO() {
+    checkBinaryRoundTrip(MVPolyType<2, int>::type("[[1 -2 3] [0] [-400000 5]]"));
+    checkBinaryRoundTrip(MVPolyType<3, NTL::GF2>::type("[[[1 0 1] [1]] [[0 1]]]"));
+    NTL::ZZ_p::init(NTL::to_ZZ(7));
+    checkBinaryRoundTrip(MVPolyType<2, NTL::ZZ_p>::type("[[1 6 3] [0 5]]"));
+    NTL::ZZ_p::init(NTL::to_ZZ(2));
+
+    typedef NTLPrimeFieldTtraits<NTL::GF2>::ExtField ExtField;
+    initExtendedField<NTL::GF2>("[1 1 0 0 1]");
+    MVPolyType<2, ExtField>::type p("[[[1 1 0 1]] [[1] [0 1 1]]]");
+    checkBinaryRoundTrip(p);
+
+    std::ostringstream os;
+    writeBinary(os, p);
+    std::string truncated = os.str().substr(0, os.str().size() - 1);
+    std::istringstream is(truncated);
+    bool thrown = false;
+    try {
+        readBinary(is, p);
+    } catch (std::runtime_error const &) {
+        thrown = true;
+    }
+    ASSERT(thrown);
+}
+
+// the parser agrees with operator>> and reports where the text is wrong
+template<typename PolyT>
+void checkTextParsing(std::string const & s) {
+    PolyT p;
+    parsePolynomial(s, p);
+    ASSERT_EQUAL(PolyT(s), p);
+}
+
+template<typename PolyT>
+size_t parseErrorOffset(std::string const & s) {
+    PolyT p;
+    try {
+        parsePolynomial(s, p);
+    } catch (ParseError const & e) {
+        return e.getOffset();
+    }
+    return s.size() + 1;
+}
+
+void polyTextParsing() {
+    checkTextParsing<MVPolyType<2, int>::type>("[[1 -2 3] [0] [-400000 5]]");
+    checkTextParsing<MVPolyType<2, int>::type>(" [[1 2][3]]\n");
+    checkTextParsing<MVPolyType<2, int>::type>("[]");
+    checkTextParsing<MVPolyType<3, NTL::GF2>::type>("[[[1 0 1] [1]] [[0 13]]]");
+    NTL::ZZ_p::init(NTL::to_ZZ(7));
+    checkTextParsing<MVPolyType<2, NTL::ZZ_p>::type>("[[1 6 30] [-1 5]]");
+    NTL::ZZ_p::init(NTL::to_ZZ(2));
+    typedef NTLPrimeFieldTtraits<NTL::GF2>::ExtField ExtField;
+    initExtendedField<NTL::GF2>("[1 1 0 0 1]");
+    checkTextParsing<MVPolyType<2, ExtField>::type>("[[[1 1 0 1]] [[1] [0 1 1] []]]");
+
+    typedef MVPolyType<2, int>::type PolyT;
+    ASSERT_EQUAL(10u, parseErrorOffset<PolyT>("[[1 2] [3 x]]"));
+    ASSERT_EQUAL(12u, parseErrorOffset<PolyT>("[[1 2] [3]] ["));
+    ASSERT_EQUAL(10u, parseErrorOffset<PolyT>("[[1 2] [3]"));
+    ASSERT_EQUAL(2u, parseErrorOffset<PolyT>("[[99999999999999999999]]"));
+    ASSERT_EQUAL(0u, parseErrorOffset<PolyT>("1"));
+
+    // several polynomials in one buffer
+    std::string const text = "[[1]] [[2 3] [4]]\n[[5]]\n";
+    TextReader reader(text);
+    std::vector<PolyT> polys;
+    PolyT p;
+    while (parseNext(reader, p))
+        polys.push_back(p);
+    ASSERT_EQUAL(3u, polys.size());
+    ASSERT_EQUAL(PolyT("[[2 3] [4]]"), polys[1]);
+}
+
+// archives are read in place and only by the field they were written for
+template<typename T>
+void checkArchiveRoundTrip(std::vector<typename MVPolyType<2, T>::type> const & polys) {
+    typedef typename MVPolyType<2, T>::type PolyT;
+    std::ostringstream os;
+    {
+        PolyArchiveWriter<2, T> writer(os);
+        writer.write(polys.front());
+        writer.writeCollection(polys);
+        typename BMSAlgorithm<PolyT>::PolynomialCollection minset(
+                polys.begin(), polys.end());
+        writer.writeCollection(minset);
+    }
+    std::string const archive = os.str();
+    ASSERT_EQUAL(0u, archive.size() % 8);
+    PolyArchiveView<2, T> const view(archive.data(), archive.data() + archive.size());
+    ASSERT_EQUAL(3u, view.getRecordCnt());
+    ASSERT_EQUAL(1u, view.getPolynomialCnt(0));
+    ASSERT_EQUAL(polys.front(), view.readPolynomial(0));
+    std::vector<PolyT> read;
+    view.readCollection(1, read);
+    ASSERT(polys == read);
+    typename BMSAlgorithm<PolyT>::PolynomialCollection minset;
+    view.readCollection(2, minset);
+    ASSERT(std::equal(polys.begin(), polys.end(), minset.begin()));
+
+    std::array<long, 2> pt;
+    pt[0] = 1;
+    pt[1] = 1;
+    ASSERT_EQUAL(polys.back().getCoefs()[1].getCoefs()[1], view.getPolynomial(1, polys.size() - 1)[pt]);
+    pt[1] = 100;
+    ASSERT_EQUAL(CoefficientTraits<T>::addId(), view.getPolynomial(1, 0)[pt]);
+
+    std::string const truncated = archive.substr(0, archive.size() - 1);
+    bool thrown = false;
+    try {
+        PolyArchiveView<2, T>(truncated.data(), truncated.data() + truncated.size());
+    } catch (std::runtime_error const &) {
+        thrown = true;
+    }
+    ASSERT(thrown);
+}
+
+void polyArchive() {
+    std::vector<MVPolyType<2, int>::type> ints;
+    ints.push_back(MVPolyType<2, int>::type("[[1 -2 3] [0] [-400000 5]]"));
+    ints.push_back(MVPolyType<2, int>::type("[[0]]"));
+    ints.push_back(MVPolyType<2, int>::type("[[7] [0 9]]"));
+    checkArchiveRoundTrip<int>(ints);
+
+    std::vector<MVPolyType<2, NTL::GF2>::type> bits;
+    bits.push_back(MVPolyType<2, NTL::GF2>::type("[[1 0 1 1 0 1 1 1 1] [1]]"));
+    bits.push_back(MVPolyType<2, NTL::GF2>::type("[[0 1] [1 1]]"));
+    checkArchiveRoundTrip<NTL::GF2>(bits);
+
+    typedef NTLPrimeFieldTtraits<NTL::GF2>::ExtField ExtField;
+    initExtendedField<NTL::GF2>("[1 1 0 0 1]");
+    std::vector<MVPolyType<2, ExtField>::type> elems;
+    elems.push_back(MVPolyType<2, ExtField>::type("[[[1 1 0 1]] [[1] [0 1 1]]]"));
+    elems.push_back(MVPolyType<2, ExtField>::type("[[[1]] [[0 1] [1 1 1 1]]]"));
+    checkArchiveRoundTrip<ExtField>(elems);
+
+    // another modulus of the same degree
+    std::ostringstream os;
+    {
+        PolyArchiveWriter<2, ExtField> writer(os);
+        writer.write(elems.front());
+    }
+    initExtendedField<NTL::GF2>("[1 0 0 1 1]");
+    std::string const archive = os.str();
+    bool thrown = false;
+    try {
+        PolyArchiveView<2, ExtField>(archive.data(), archive.data() + archive.size());
+    } catch (std::runtime_error const &) {
+        thrown = true;
+    }
+    ASSERT(thrown);
+
+    // in place from a mapped file
+    char path[] = "/tmp/mv_poly_archiveXXXXXX";
+    int const fd = mkstemp(path);
+    ASSERT(fd >= 0);
+    close(fd);
+    {
+        std::ofstream file(path, std::ios::binary);
+        PolyArchiveWriter<2, int> writer(file);
+        writer.writeCollection(ints);
+        writer.write(ints.back());
+    }
+    {
+        MappedFile const file(path);
+        PolyArchiveView<2, int> const view(file);
+        ASSERT_EQUAL(2u, view.getRecordCnt());
+        std::vector<MVPolyType<2, int>::type> read;
+        view.readCollection(0, read);
+        ASSERT(ints == read);
+        ASSERT_EQUAL(ints.back(), view.readPolynomial(1));
+        std::array<long, 2> pt = {{ 2, 0 }};
+        ASSERT_EQUAL(-400000, view.getPolynomial(0, 0)[pt]);
+    }
+    std::remove(path);
+
+    // extents whose product overflows (2^31 * 2^31 * 4 = 0) are rejected
+    std::ostringstream os3;
+    {
+        PolyArchiveWriter<3, int> writer(os3);
+        writer.write(MVPolyType<3, int>::type("[[[1 2]]]"));
+    }
+    std::string overflowing = os3.str();
+    // after the header (16 bytes) and the record header (8 bytes)
+    char const extents[12] = { 0, 0, 0, '\x80', 0, 0, 0, '\x80', 4, 0, 0, 0 };
+    std::copy(extents, extents + 12, overflowing.begin() + 24);
+    PolyArchiveView<3, int> const view3(overflowing.data(),
+            overflowing.data() + overflowing.size());
+    thrown = false;
+    try {
+        view3.getPolynomial(0, 0);
+    } catch (std::runtime_error const &) {
+        thrown = true;
+    }
+    ASSERT(thrown);
+}
+
 void curveArithmetic() {
     typedef NTL::GF2 PrimeField;
     typedef typename NTLPrimeFieldTtraits<PrimeField>::ExtField ExtField;
@@ -402,18 +1330,62 @@ void curveArithmetic() {
             NTL::power(x, 1) + NTL::power(x, 0));
 }
 
-void bmsaDecodingCLOS05Example() {
+// all the pairs (x, y) checked in the order of the code positions
+template<int r>
+void checkHermitianRationalPoints(std::string const & field) {
     typedef NTL::GF2 PrimeField;
     typedef typename NTLPrimeFieldTtraits<PrimeField>::ExtField ExtField;
+    typedef std::array<ExtField, 2> CPt;
+
+    initExtendedField<PrimeField>(field);
+    ExtField const a = getPrimitive<ExtField>();
+    std::vector<ExtField> elems(1);  // 0, 1, a, a^2, ...
+    ExtField x = FieldElemTraits<ExtField>::multId();
+    for (int i = 0; i < r * r - 1; ++i, x *= a)
+        elems.push_back(x);
+    std::vector<CPt> expected;
+    for (size_t i = 0; i < elems.size(); ++i)
+        for (size_t j = 0; j < elems.size(); ++j) {
+            CPt const cp = {{ elems[i], elems[j] }};
+            if (isPlainHermitianCurveRationalPoint<ExtField>(r, cp))
+                expected.push_back(cp);
+        }
+
+    std::vector<CPt> const points =
+            getPlainHermitianCurveRationalPoints<r, CPt, ExtField>();
+    ASSERT_EQUAL(size_t(r * r * r), points.size());
+    ASSERT(expected == points);
+}
 
-    initExtendedField<PrimeField>("[1 1 1]");
-    //ExtField a = FieldElemTraits<ExtField>::getPrimitive();
-    FieldElemTraits<ExtField>::setPrimitive(getPrimitive<ExtField>());
+void hermitianRationalPoints() {
+    checkHermitianRationalPoints<2>("[1 1 1]");
+    checkHermitianRationalPoints<4>("[1 1 0 0 1]");
+    checkHermitianRationalPoints<8>("[1 1 0 0 0 0 1]");
+}
+
+// the Hermitian code over F_{r^2} the decoding tests share, with the field
+// initialised (its primitive element too) by init
+template<int r>
+struct HermitianTestCode {
+    typedef NTL::GF2 PrimeField;
+    typedef typename NTLPrimeFieldTtraits<PrimeField>::ExtField ExtField;
+    static const int Dim = 2;
+    typedef HermitianCodeParams<r, ExtField> CodeParams;
+    typedef BMSDecoding<Dim, CodeParams> BMSDecoderT;
+
+    static void init(std::string const & field) {
+        initExtendedField<PrimeField>(field);
+    }
+};
+
+void bmsaDecodingCLOS05Example() {
+    // field F_q, where q = r^2 -- we have F_4, so r = 2
+    typedef HermitianTestCode<2> Code;
+    typedef Code::ExtField ExtField;
+    typedef Code::BMSDecoderT BMSDecoderT;
+    Code::init("[1 1 1]");
 
-    const int Dim = 2;
-    const int r = 2; // field F_q, where q = r^2 -- we have F_4, so r = 2
     const int n = 8;
-    typedef BMSDecoding<Dim, HermitianCodeParams<r, ExtField> > BMSDecoderT;
     BMSDecoderT bms_decoder(5); // C_4 code
     BMSDecoderT::FieldElemsCollection e;
     e.resize(n);
@@ -423,9 +1395,384 @@ void bmsaDecodingCLOS05Example() {
     e[pos1] = FieldElemTraits<ExtField>::multId(); // = 1
     e[pos2] = e[pos1];
 
-    auto locs = bms_decoder.decode(e);
+    auto locs = bms_decoder.locateErrors(e);
     auto refLocs = decltype(locs){pos1, pos2};
     ASSERT_EQUAL(locs, refLocs);
+    ASSERT_EQUAL(BMSDecoderT::FieldElemsCollection(n), bms_decoder.decode(e));
+
+#if MV_POLY_PERF_COUNTERS
+    std::ostringstream os;
+    bms_decoder.writeCountersJson(os);
+    string const json = os.str();
+    ASSERT_EQUAL(0u, json.find("{\"words\": 2, \"syndromeTime\": "));
+    ASSERT(json.find("\"bmsa\": {\"total\": {\"convolutions\": ") != string::npos);
+#endif
+}
+
+void bmsaDecodingBatch() {
+    typedef HermitianTestCode<2> Code;
+    typedef Code::ExtField ExtField;
+    typedef Code::BMSDecoderT BMSDecoderT;
+    Code::init("[1 1 1]");
+
+    const int n = 8;
+    BMSDecoderT bms_decoder(5);
+    ExtField a = getPrimitive<ExtField>();
+
+    std::vector<BMSDecoderT::FieldElemsCollection> words(6,
+            BMSDecoderT::FieldElemsCollection(n));
+    words[1][1] = words[1][7] = FieldElemTraits<ExtField>::multId();
+    words[2][3] = a;
+    words[3][0] = a;
+    words[3][5] = a * a;
+    words[4] = words[1];
+    words[5][6] = FieldElemTraits<ExtField>::multId();
+
+    auto corrected = bms_decoder.decodeBatch(words);
+    ASSERT_EQUAL(words.size(), corrected.size());
+    for (size_t i = 0; i < words.size(); ++i)
+        ASSERT_EQUAL(bms_decoder.decode(words[i]), corrected[i]);
+}
+
+// the tables of the context and the decoders sharing it
+void bmsaDecodingCodeContext() {
+    typedef HermitianTestCode<2> Code;
+    typedef Code::ExtField ExtField;
+    typedef Code::BMSDecoderT BMSDecoderT;
+    Code::init("[1 1 1]");
+
+    const int n = 8;
+    typedef BMSDecoderT::Context ContextT;
+    ContextT const context(5);
+    ASSERT_EQUAL(n, context.getCurvePoints().size());
+    ASSERT_EQUAL(5u, context.getBasis().size());
+    ASSERT_EQUAL(2, context.getCorrectable());
+
+    auto const & points = context.getSyndromePoints();
+    auto const & h = context.getParityCheckMatrix();
+    ASSERT_EQUAL(points.size() * n, h.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        ASSERT_EQUAL(long(i), context.rank(points[i]));
+        for (size_t p = 0; p < n; ++p)
+            ASSERT_EQUAL(computeMonomAtPoint<ExtField>(points[i],
+                    context.getCurvePoints()[p]), h[i * n + p]);
+    }
+
+    BMSDecoderT const first(context), second(context);
+    ASSERT_EQUAL(&context, &first.getContext());
+    ASSERT_EQUAL(2, first.getCorrectable());
+    BMSDecoderT::FieldElemsCollection e(n);
+    e[2] = e[6] = getPrimitive<ExtField>();
+    ASSERT_EQUAL(BMSDecoderT::FieldElemsCollection(n), first.decode(e));
+    ASSERT_EQUAL(first.decode(e), second.decode(e));
+    ASSERT_EQUAL(first.decode(e), BMSDecoderT(5).decode(e));
+}
+
+// syndromes of a batch as a product of the parity-check matrix by the words
+void bmsaDecodingBatchSyndromes() {
+    // blocks smaller than the matrices, which aren't multiples of them
+    size_t const m = 7, k = 5, n = 9;
+    std::vector<long> a(m * k), b(k * n), c(m * n, 0);
+    for (size_t i = 0; i < a.size(); ++i)
+        a[i] = (i * 7) % 5;  // with zeros
+    for (size_t i = 0; i < b.size(); ++i)
+        b[i] = long(i) - 11;
+    for (size_t i = 0; i < m; ++i)
+        for (size_t j = 0; j < n; ++j)
+            for (size_t p = 0; p < k; ++p)
+                c[i * n + j] += a[i * k + p] * b[p * n + j];
+    ASSERT_EQUAL(c, multiplyBlocked(m, k, n, a, b, MatrixBlocking(2, 3, 4)));
+    ASSERT_EQUAL(c, multiplyBlocked(m, k, n, a, b));
+
+    typedef HermitianTestCode<2> Code;
+    typedef Code::ExtField ExtField;
+    typedef Code::BMSDecoderT BMSDecoderT;
+    Code::init("[1 1 1]");
+
+    BMSDecoderT const bms_decoder(5);
+    auto const & cpts = bms_decoder.getContext().getCurvePoints();
+    auto const & points = bms_decoder.getContext().getSyndromePoints();
+    ExtField const a1 = getPrimitive<ExtField>();
+
+    std::vector<BMSDecoderT::FieldElemsCollection> words(5,
+            BMSDecoderT::FieldElemsCollection(cpts.size()));
+    for (size_t w = 0; w < words.size(); ++w)
+        for (size_t p = 0; p < cpts.size(); ++p)
+            words[w][p] = NTL::power(a1, long(w * p % 4));
+
+    auto const syndromes = bms_decoder.computeSyndromesBatch(words);
+    ASSERT_EQUAL(words.size(), syndromes.size());
+    for (size_t w = 0; w < words.size(); ++w)
+        for (size_t i = 0; i < points.size(); ++i) {
+            ExtField s;
+            for (size_t p = 0; p < cpts.size(); ++p)
+                s += words[w][p] * computeMonomAtPoint<ExtField>(points[i], cpts[p]);
+            ASSERT_EQUAL(s, syndromes[w][points[i]]);
+        }
+}
+
+// a job a stage throws on is popped as the exception, in place of its result
+void pipelineStageErrors() {
+    Pipeline<int> pipeline(2);
+    pipeline.addStage("double", [](int & job) {
+        if (job == 3)
+            throw std::runtime_error("job 3");
+        job *= 2;
+    }, 2);
+    pipeline.addStage("increment", [](int & job) { ++job; });
+    pipeline.start();
+    std::thread producer([&pipeline]() {
+        for (int i = 0; i < 8; ++i)
+            pipeline.push(i);
+        pipeline.close();
+    });
+    // a pop per pushed job
+    std::vector<int> done;
+    int failed = -1;
+    for (int i = 0; i < 8; ++i) {
+        int job = -1;
+        try {
+            ASSERT(pipeline.pop(job));
+            done.push_back(job);
+        } catch (std::runtime_error const &) {
+            failed = job;
+        }
+    }
+    int job;
+    ASSERT(!pipeline.pop(job));
+    producer.join();
+    ASSERT_EQUAL(3, failed);
+    std::sort(done.begin(), done.end());
+    ASSERT_EQUAL((std::vector<int>{ 1, 3, 5, 9, 11, 13, 15 }), done);
+}
+
+// a stream of words decoded by the pipeline as by decode
+void bmsaDecodingPipeline() {
+    typedef HermitianTestCode<2> Code;
+    typedef Code::ExtField ExtField;
+    typedef Code::BMSDecoderT BMSDecoderT;
+    Code::init("[1 1 1]");
+
+    const int n = 8;
+    typedef BMSDecodingPipeline<Code::Dim, Code::CodeParams> PipelineT;
+    BMSDecoderT const bms_decoder(5);
+    ExtField const a = getPrimitive<ExtField>();
+
+    // every pair of errors (and no errors)
+    std::vector<BMSDecoderT::FieldElemsCollection> words(1,
+            BMSDecoderT::FieldElemsCollection(n));
+    for (int i = 0; i < n; ++i)
+        for (int j = i + 1; j < n; ++j) {
+            words.push_back(BMSDecoderT::FieldElemsCollection(n));
+            words.back()[i] = a;
+            words.back()[j] = NTL::power(a, i + j);
+        }
+
+    NTL::GF2EContext ntlContext;
+    ntlContext.save();
+    std::vector<BMSDecoderT::FieldElemsCollection> corrected(words.size());
+    std::ostringstream os;
+    {
+        // queues shorter than the stream: pushing waits for the stages
+        PipelineT pipeline(bms_decoder, PipelineT::StageThreads(1, 3, 2, 1), 4,
+                [ntlContext]() { ntlContext.restore(); });
+        std::thread producer([&pipeline, &words]() {
+            for (size_t i = 0; i < words.size(); ++i)
+                pipeline.push(i, words[i]);
+            pipeline.close();
+        });
+        size_t index, cnt = 0;
+        BMSDecoderT::FieldElemsCollection word;
+        while (pipeline.pop(index, word)) {
+            corrected[index] = word;
+            ++cnt;
+        }
+        producer.join();
+        ASSERT_EQUAL(words.size(), cnt);
+        pipeline.writeJson(os);
+    }
+    for (size_t i = 0; i < words.size(); ++i)
+        ASSERT_EQUAL(BMSDecoderT::FieldElemsCollection(n), corrected[i]);
+
+    string const json = os.str();
+    ASSERT_EQUAL(0u, json.find("{\"latency\": {\"count\": 29, "));
+    ASSERT(json.find("{\"name\": \"bmsa\", \"threads\": 3, \"latency\": {\"count\": 29, ")
+            != string::npos);
+}
+
+// voters of the delta-set grid as by checking every point below k
+template<int Dim>
+void checkDeltaSetGridVotes(std::vector< Point<Dim> > const & maxPoints,
+        std::vector< Point<Dim> > const & degs) {
+    typedef Point<Dim> Pt;
+    DeltaSetGrid<Pt> delta;
+    delta.update(maxPoints);
+    auto const inDelta = [&maxPoints](Pt const & q) {
+        for (auto const & c : maxPoints)
+            if (byCoordinateLess(q, c))
+                return true;
+        return false;
+    };
+    // every other point is a basis element
+    auto const isBasisElem = [](Pt const & q) {
+        return std::accumulate(q.begin(), q.end(), 0) % 3 != 1;
+    };
+    std::array<long, Dim> extents;
+    extents.fill(7);
+    BoxLayout<Dim> const box(extents);
+    Pt k, q, rest;
+    for (long r = 0; r < box.size(); ++r) {
+        box.unrank(r, k);
+        std::vector<unsigned> votes(degs.size(), 0), expected(degs.size(), 0);
+        delta.countVotes(degs, k, isBasisElem, votes);
+        for (long s = 0; s < box.size(); ++s) {
+            box.unrank(s, q);
+            if (!byCoordinateLess(q, k))
+                continue;
+            for (int i = 0; i < Dim; ++i)
+                rest[i] = k[i] - q[i];
+            ASSERT_EQUAL(inDelta(q), delta.contains(q));
+            if (inDelta(q) || inDelta(rest)
+                    || !isBasisElem(q) || !isBasisElem(rest))
+                continue;
+            size_t i = 0;
+            while (!byCoordinateLess(degs[i], q))
+                ++i;
+            ++expected[i];
+        }
+        ASSERT_EQUAL(expected, votes);
+    }
+}
+
+void deltaSetGridVotes() {
+    checkDeltaSetGridVotes<2>({ Point<2>{ 0, 3 }, Point<2>{ 2, 1 }, Point<2>{ 4, 0 } },
+            { Point<2>{ 5, 0 }, Point<2>{ 3, 1 }, Point<2>{ 0, 4 }, Point<2>{ 1, 2 } });
+    checkDeltaSetGridVotes<3>({ Point<3>{ 1, 0, 2 }, Point<3>{ 0, 2, 0 } },
+            { Point<3>{ 2, 0, 0 }, Point<3>{ 0, 3, 0 }, Point<3>{ 0, 0, 3 },
+              Point<3>{ 1, 1, 0 }, Point<3>{ 0, 1, 1 }, Point<3>{ 1, 0, 3 } });
+}
+
+// every error pattern within half the Feng-Rao distance is decoded
+void bmsaDecodingMajorityVoting() {
+    typedef HermitianTestCode<2> Code;
+    typedef Code::ExtField ExtField;
+    typedef Code::BMSDecoderT BMSDecoderT;
+    Code::init("[1 1 1]");
+
+    const int n = 8;
+    BMSDecoderT bms_decoder(5); // C_4 code: Feng-Rao distance 5
+    ASSERT_EQUAL(2, bms_decoder.getCorrectable());
+    ExtField a = getPrimitive<ExtField>();
+    ExtField const values[] = { FieldElemTraits<ExtField>::multId(), a, a * a };
+
+    std::vector<BMSDecoderT::FieldElemsCollection> words;
+    std::vector< std::vector<int> > positions;
+    for (int p = 0; p < n; ++p)
+        for (int q = p; q < n; ++q)
+            for (int i = 0; i < 3; ++i)
+                for (int j = 0; j < (p == q ? 1 : 3); ++j) {
+                    BMSDecoderT::FieldElemsCollection e(n);
+                    e[p] = values[i];
+                    e[q] = values[j];
+                    words.push_back(e);
+                    positions.push_back(p == q
+                            ? std::vector<int>{p} : std::vector<int>{p, q});
+                }
+    ASSERT_EQUAL(24u + 252u, words.size());
+    for (size_t i = 0; i < words.size(); ++i)
+        ASSERT_EQUAL(positions[i], bms_decoder.locateErrors(words[i]));
+    std::vector<BMSDecoderT::FieldElemsCollection> const zeros(words.size(),
+            BMSDecoderT::FieldElemsCollection(n));
+    ASSERT_EQUAL(zeros, bms_decoder.decodeBatch(words));
+}
+
+// error values for staircases with several maximal points (Hermitian code
+// over F_16)
+void bmsaDecodingErrorValues() {
+    typedef HermitianTestCode<4> Code;
+    typedef Code::ExtField ExtField;
+    typedef Code::BMSDecoderT BMSDecoderT;
+    Code::init("[1 1 0 0 1]");
+
+    const int n = 64;
+    BMSDecoderT bms_decoder(20);
+    ASSERT_EQUAL(7, bms_decoder.getCorrectable());
+    ExtField const a = getPrimitive<ExtField>();
+
+    // the received word is the error itself (the codeword is zero)
+    unsigned long seed = 1;
+    std::vector<BMSDecoderT::FieldElemsCollection> words;
+    for (int errors = 1; errors <= 7; ++errors)
+        for (int i = 0; i < 2; ++i) {
+            BMSDecoderT::FieldElemsCollection e(n);
+            for (int j = 0; j < errors; ) {
+                seed = seed * 1103515245 + 12345;
+                int const pos = seed / 65536 % n;
+                if (e[pos] != ExtField())
+                    continue;
+                e[pos] = NTL::power(a, seed / 64 % 15);
+                ++j;
+            }
+            words.push_back(e);
+        }
+    std::vector<BMSDecoderT::FieldElemsCollection> const zeros(words.size(),
+            BMSDecoderT::FieldElemsCollection(n));
+    for (size_t i = 0; i < words.size(); ++i)
+        ASSERT_EQUAL(zeros[i], bms_decoder.decode(words[i]));
+    ASSERT_EQUAL(zeros, bms_decoder.decodeBatch(words));
+}
+
+// code words of the systematic encoder are decoded back from errors
+void systematicEncoding() {
+    typedef HermitianTestCode<4> Code;
+    typedef Code::ExtField ExtField;
+    typedef Code::BMSDecoderT BMSDecoderT;
+    Code::init("[1 1 0 0 1]");
+
+    const size_t n = 64, l = 20;
+    typedef SystematicEncoder<Code::Dim, Code::CodeParams> EncoderT;
+    BMSDecoderT::Context const context(l);
+    BMSDecoderT const bms_decoder(context);
+    EncoderT const encoder(context);
+    size_t const k = encoder.getDimension();
+    ASSERT_EQUAL(n, encoder.getLength());
+    ASSERT_EQUAL(n - l, k);
+    ExtField const a = getPrimitive<ExtField>();
+
+    // the rows of the generator matrix are the code words of unit messages
+    std::vector<ExtField> const g = encoder.getGeneratorMatrix();
+    for (size_t f = 0; f < k; ++f) {
+        EncoderT::FieldElemsCollection unit(k);
+        unit[f] = FieldElemTraits<ExtField>::multId();
+        ASSERT_EQUAL(EncoderT::FieldElemsCollection(g.begin() + f * n,
+                g.begin() + (f + 1) * n), encoder.encode(unit));
+    }
+
+    std::vector<EncoderT::FieldElemsCollection> messages;
+    unsigned long seed = 7;
+    for (int w = 0; w < 8; ++w) {
+        messages.push_back(EncoderT::FieldElemsCollection(k));
+        for (size_t f = 0; f < k; ++f) {
+            seed = seed * 1103515245 + 12345;
+            messages.back()[f] = NTL::power(a, seed / 65536 % 15);
+        }
+    }
+    std::vector<EncoderT::FieldElemsCollection> const words =
+            encoder.encodeBatch(messages);
+    std::vector<BMSDecoderT::SyndromeType> const syndromes =
+            bms_decoder.computeSyndromesBatch(words);
+    std::vector<BMSDecoderT::FieldElemsCollection> received = words;
+    for (size_t w = 0; w < words.size(); ++w) {
+        ASSERT_EQUAL(encoder.encode(messages[w]), words[w]);
+        for (size_t f = 0; f < k; ++f)
+            ASSERT_EQUAL(messages[w][f],
+                    words[w][encoder.getInformationPositions()[f]]);
+        for (auto const & pt : context.getSyndromePoints())
+            ASSERT_EQUAL(ExtField(), syndromes[w][pt]);
+        for (size_t e = 0; e < w; ++e)  // up to 7 errors
+            received[w][(w + 9 * e) % n] += NTL::power(a, e);
+    }
+    ASSERT_EQUAL(words, bms_decoder.decodeBatch(received));
 }
 
 void runSuites() {
@@ -438,29 +1785,61 @@ void runSuites() {
     PolyIOSuite.push_back(CUTE(inputTestForNPolyOverGF));
     PolyIOSuite.push_back(CUTE(polySubscript));
     PolyIOSuite.push_back(CUTE(testPolyToDegCoefMapConversion));
+    PolyIOSuite.push_back(CUTE(nonzeroTermRanges));
+    PolyIOSuite.push_back(CUTE(denseSequence));
     PolyIOSuite.push_back(CUTE(polyPowerPrinting));
+    PolyIOSuite.push_back(CUTE(polyBinaryIO));
+    PolyIOSuite.push_back(CUTE(polyTextParsing));
+    PolyIOSuite.push_back(CUTE(polyArchive));
     cute::makeRunner(lis)(PolyIOSuite, "The Polynomial Input-Output Suite");
 
     cute::suite PointSuite;
     PointSuite.push_back(CUTE(pointComparison));
     PointSuite.push_back(CUTE(pointIncreasing));
+    PointSuite.push_back(CUTE(pointIncreasingWeighted));
+    PointSuite.push_back(CUTE(pointIncreasingConcurrently));
     PointSuite.push_back(CUTE(pointCollectionOperations));
 
     cute::suite PolynomialArithmeticSuite;
     PolynomialArithmeticSuite.push_back(CUTE(convolutionTest));
+    PolynomialArithmeticSuite.push_back(CUTE(convolutionSupportRestricted));
     PolynomialArithmeticSuite.push_back(CUTE(monomialMultiplication));
     PolynomialArithmeticSuite.push_back(CUTE(scalarMultiplication));
     PolynomialArithmeticSuite.push_back(CUTE(summation));
     PolynomialArithmeticSuite.push_back(CUTE(equality));
     PolynomialArithmeticSuite.push_back(CUTE(eval));
+    PolynomialArithmeticSuite.push_back(CUTE(unrolledKernels));
+    PolynomialArithmeticSuite.push_back(CUTE(directConstruction));
 
     cute::suite bmsaTestingSuite;
     bmsaTestingSuite.push_back(CUTE(sakatasExample2D));
     bmsaTestingSuite.push_back(CUTE(sakatasExample3D));
+    bmsaTestingSuite.push_back(CUTE(sakatasExamplesDenseSequence));
+    bmsaTestingSuite.push_back(CUTE(sakatasExamplesSupportCaching));
+    bmsaTestingSuite.push_back(CUTE(flatMapOperations));
+    bmsaTestingSuite.push_back(CUTE(workStealingPool));
+    bmsaTestingSuite.push_back(CUTE(sakatasExamplesParallel));
+    bmsaTestingSuite.push_back(CUTE(sakatasExamplesStreaming));
+    bmsaTestingSuite.push_back(CUTE(sakatasExamplesCheckpoint));
+    bmsaTestingSuite.push_back(CUTE(sakatasExamplesBatched));
+    bmsaTestingSuite.push_back(CUTE(sakatasExampleTraced));
+#if MV_POLY_PERF_COUNTERS
+    bmsaTestingSuite.push_back(CUTE(sakatasExamplePerfCounters));
+#endif
 
     cute::suite bmsaDecoding;
     bmsaDecoding.push_back(CUTE(curveArithmetic));
+    bmsaDecoding.push_back(CUTE(hermitianRationalPoints));
     bmsaDecoding.push_back(CUTE(bmsaDecodingCLOS05Example));
+    bmsaDecoding.push_back(CUTE(bmsaDecodingBatch));
+    bmsaDecoding.push_back(CUTE(bmsaDecodingCodeContext));
+    bmsaDecoding.push_back(CUTE(bmsaDecodingBatchSyndromes));
+    bmsaDecoding.push_back(CUTE(pipelineStageErrors));
+    bmsaDecoding.push_back(CUTE(bmsaDecodingPipeline));
+    bmsaDecoding.push_back(CUTE(deltaSetGridVotes));
+    bmsaDecoding.push_back(CUTE(bmsaDecodingMajorityVoting));
+    bmsaDecoding.push_back(CUTE(bmsaDecodingErrorValues));
+    bmsaDecoding.push_back(CUTE(systematicEncoding));
 
     cute::makeRunner(lis)(PointSuite, 
             "The Point Suite");
@@ -0,0 +1,340 @@
+/**
+ * @file TextParser.hpp
+ *
+ * Parser of polynomials in the text format of <tt>operator<<</tt>
+ * (<tt>[[a b c][e f]]</tt>) working on a character buffer: a string, a
+ * memory-mapped file or any other range of bytes. It doesn't go through
+ * streams, builds the coefficients in the polynomials directly and reports
+ * malformed input by ParseError with the offset of the offending byte.
+ *
+ * The coefficients are parsed by TextTraits: machine integers, GF2, ZZ_p
+ * and GF2E literals are read by hand, other types through their
+ * <tt>operator>></tt> on the text of the literal.
+ */
+
+#ifndef TEXTPARSER_HPP_
+#define TEXTPARSER_HPP_
+
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include <cstddef>
+
+#include <boost/type_traits/is_integral.hpp>
+#include <boost/utility/enable_if.hpp>
+
+#include <NTL/GF2.h>
+#include <NTL/GF2E.h>
+#include <NTL/GF2X.h>
+#include <NTL/ZZ_p.h>
+
+#include "mv_poly.hpp"
+#include "MappedFile.hpp"
+
+namespace mv_poly {
+
+/// Malformed text: what went wrong and at which byte of the input.
+class ParseError : public std::runtime_error {
+public:
+    ParseError(std::string const & message, size_t offset_) :
+            std::runtime_error(makeMessage(message, offset_)),
+            offset(offset_) {}
+
+    size_t getOffset() const {
+        return offset;
+    }
+
+private:
+    static std::string makeMessage(std::string const & message, size_t offset) {
+        std::ostringstream os;
+        os << message << " at byte " << offset;
+        return os.str();
+    }
+
+    size_t offset;
+};
+
+/**
+ * \class TextReader
+ * Cursor over the bytes [begin, end), which the reader doesn't own. The
+ * polynomials are read from it one after another (cf. parseNext).
+ */
+class TextReader {
+public:
+    TextReader(char const * begin_, char const * end_) :
+        begin(begin_), pos(begin_), end(end_) {}
+
+    explicit TextReader(std::string const & s) :
+        begin(s.data()), pos(s.data()), end(s.data() + s.size()) {}
+
+    void skipSpace() {
+        while (pos != end && (*pos == ' ' || *pos == '\t' || *pos == '\n'
+                || *pos == '\r' || *pos == '\f' || *pos == '\v'))
+            ++pos;
+    }
+
+    /// True if only whitespace is left.
+    bool atEnd() {
+        skipSpace();
+        return pos == end;
+    }
+
+    /// The current byte, 0 at the end.
+    char peek() const {
+        return pos == end ? 0 : *pos;
+    }
+
+    void advance() {
+        ++pos;
+    }
+
+    /// Skips whitespace and \c c.
+    void expect(char c) {
+        skipSpace();
+        if (peek() != c)
+            fail(std::string("expected '") + c + "'");
+        ++pos;
+    }
+
+    /// Offset of the current byte from the beginning.
+    size_t offset() const {
+        return pos - begin;
+    }
+
+    char const * current() const {
+        return pos;
+    }
+
+    /// Moves to \c p (between the current byte and the end).
+    void seek(char const * p) {
+        pos = p;
+    }
+
+    char const * getEnd() const {
+        return end;
+    }
+
+    void fail(std::string const & message) const {
+        failAt(message, offset());
+    }
+
+    void failAt(std::string const & message, size_t at) const {
+        throw ParseError(message, at);
+    }
+
+    /**
+     * Skips whitespace and a literal: a bracketed group (with the nested
+     * ones) or a run of bytes up to whitespace or a bracket.
+     * @return Start of the literal.
+     */
+    char const * skipLiteral() {
+        skipSpace();
+        char const * const start = pos;
+        if (peek() == '[') {
+            int depth = 0;
+            do {
+                if (pos == end)
+                    failAt("unterminated literal", start - begin);
+                if (*pos == '[')
+                    ++depth;
+                else if (*pos == ']')
+                    --depth;
+                ++pos;
+            } while (depth > 0);
+        } else {
+            while (pos != end && *pos != '[' && *pos != ']' && *pos != ' '
+                    && *pos != '\t' && *pos != '\n' && *pos != '\r')
+                ++pos;
+        }
+        if (pos == start)
+            fail("expected literal");
+        return start;
+    }
+
+    /**
+     * Reads an optionally signed decimal integer.
+     * @param value Its value if it fits in long.
+     * @param lastDigit Its last digit.
+     * @return False if it doesn't fit in long (the cursor is after it anyway).
+     */
+    bool readInteger(long & value, int & lastDigit) {
+        skipSpace();
+        size_t const start = offset();
+        bool negative = false;
+        if (peek() == '-' || peek() == '+') {
+            negative = peek() == '-';
+            ++pos;
+        }
+        if (peek() < '0' || peek() > '9')
+            failAt("expected integer", start);
+        unsigned long magnitude = 0;
+        unsigned long const limit = negative
+                ? static_cast<unsigned long>(std::numeric_limits<long>::max()) + 1
+                : std::numeric_limits<long>::max();
+        bool fits = true;
+        while (peek() >= '0' && peek() <= '9') {
+            lastDigit = *pos - '0';
+            if (magnitude > (limit - lastDigit) / 10)
+                fits = false;
+            else
+                magnitude = magnitude * 10 + lastDigit;
+            ++pos;
+        }
+        if (fits)
+            value = negative ? static_cast<long>(0ul - magnitude)
+                    : static_cast<long>(magnitude);
+        return fits;
+    }
+
+private:
+    char const * const begin;
+
+    char const * pos;
+
+    char const * const end;
+};
+
+/// Reads the next literal of \c reader by <tt>operator>></tt>.
+template<typename T>
+void parseByStream(TextReader & reader, T & value) {
+    reader.skipSpace();
+    size_t const at = reader.offset();
+    char const * const start = reader.skipLiteral();
+    std::istringstream is(std::string(start, reader.current()));
+    if (!(is >> value))
+        reader.failAt("malformed coefficient", at);
+}
+
+/**
+ * \class TextTraits
+ * Parsing of a literal of type T: <tt>parse(reader, value)</tt>. The
+ * general version reads it by <tt>operator>></tt> (cf. parseByStream).
+ */
+template<typename T, typename Enable = void>
+struct TextTraits {
+    static void parse(TextReader & reader, T & value) {
+        parseByStream(reader, value);
+    }
+};
+
+template<typename T>
+struct TextTraits<
+        T,
+        typename boost::enable_if< boost::is_integral<T> >::type > {
+
+    static void parse(TextReader & reader, T & value) {
+        reader.skipSpace();
+        size_t const at = reader.offset();
+        long v;
+        int last;
+        if (!reader.readInteger(v, last)
+                || v < static_cast<long>(std::numeric_limits<T>::min())
+                || (v > 0 && static_cast<unsigned long>(v)
+                        > static_cast<unsigned long>(std::numeric_limits<T>::max())))
+            reader.failAt("integer out of range", at);
+        value = static_cast<T>(v);
+    }
+};
+
+/// Integer taken modulo 2: only its last digit matters.
+template<>
+struct TextTraits<NTL::GF2> {
+    static void parse(TextReader & reader, NTL::GF2 & value) {
+        long v;
+        int last = 0;
+        reader.readInteger(v, last);
+        NTL::conv(value, long(last & 1));
+    }
+};
+
+/// Integer reduced modulo p, the ones out of long by NTL::ZZ.
+template<>
+struct TextTraits<NTL::ZZ_p> {
+    static void parse(TextReader & reader, NTL::ZZ_p & value) {
+        reader.skipSpace();
+        char const * const start = reader.current();
+        long v;
+        int last;
+        if (reader.readInteger(v, last)) {
+            NTL::conv(value, v);
+            return;
+        }
+        reader.seek(start);
+        parseByStream(reader, value);
+    }
+};
+
+/// GF2X literal <tt>[a_0 a_1 ...]</tt> reduced modulo the GF2E modulus.
+template<>
+struct TextTraits<NTL::GF2E> {
+    static void parse(TextReader & reader, NTL::GF2E & value) {
+        reader.expect('[');
+        NTL::GF2X poly;
+        long i = 0;
+        for (reader.skipSpace(); reader.peek() != ']'; reader.skipSpace(), ++i) {
+            if (reader.peek() == 0)
+                reader.fail("unterminated GF2E literal");
+            long v;
+            int last = 0;
+            reader.readInteger(v, last);
+            if (last & 1)
+                NTL::SetCoeff(poly, i);
+        }
+        reader.advance();
+        NTL::conv(value, poly);
+    }
+};
+
+/// <tt>[c_0 c_1 ...]</tt>, the coefficients are parsed in the storage.
+template<typename T>
+struct TextTraits< Polynomial<T> > {
+    static void parse(TextReader & reader, Polynomial<T> & p) {
+        reader.expect('[');
+        typename Polynomial<T>::StorageT coefs;
+        for (reader.skipSpace(); reader.peek() != ']'; reader.skipSpace()) {
+            if (reader.peek() == 0)
+                reader.fail("unterminated polynomial");
+            coefs.push_back(T());
+            TextTraits<T>::parse(reader, coefs.back());
+        }
+        reader.advance();
+        if (coefs.empty())
+            p = Polynomial<T>();
+        else
+            p.swapCoefs(coefs);
+    }
+};
+
+/**
+ * Parses the next polynomial of \c reader (for several polynomials in one
+ * buffer).
+ * @return False if only whitespace is left.
+ */
+template<typename T>
+bool parseNext(TextReader & reader, Polynomial<T> & p) {
+    if (reader.atEnd())
+        return false;
+    TextTraits< Polynomial<T> >::parse(reader, p);
+    return true;
+}
+
+/// Parses the bytes [begin, end), which have to hold one polynomial.
+template<typename T>
+void parsePolynomial(char const * begin, char const * end, Polynomial<T> & p) {
+    TextReader reader(begin, end);
+    if (!parseNext(reader, p))
+        reader.fail("expected polynomial");
+    if (!reader.atEnd())
+        reader.fail("trailing characters");
+}
+
+template<typename T>
+void parsePolynomial(std::string const & s, Polynomial<T> & p) {
+    parsePolynomial(s.data(), s.data() + s.size(), p);
+}
+
+} // namespace mv_poly
+
+#endif /* TEXTPARSER_HPP_ */
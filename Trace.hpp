@@ -0,0 +1,46 @@
+/**
+ * @file Trace.hpp
+ *
+ * Compile-time levels of diagnostic logging of BMS-algorithm and decoding.
+ *
+ * glog filters INFO messages at run time only after the operands of
+ * <tt>operator<<</tt> have been formatted, and the algorithm logs whole F
+ * and G at every step. Here the level is fixed at compile time:
+ * \code
+ * g++ -DMV_POLY_TRACE_LEVEL=0 ...   // no diagnostic logging at all
+ * \endcode
+ * Messages above the level are under a constant false condition, so the
+ * compiler drops them together with the formatting code.
+ */
+
+#ifndef TRACE_HPP_
+#define TRACE_HPP_
+
+#include <glog/logging.h>
+
+/// Nothing is logged.
+#define MV_POLY_TRACE_OFF 0
+
+/// A line or two per run of the algorithm or of a batch, nothing that is
+/// formatted per error of a word.
+#define MV_POLY_TRACE_SUMMARY 1
+
+/// Everything that happens at every step, including F and G, the error
+/// positions and values.
+#define MV_POLY_TRACE_STEPS 2
+
+#ifndef MV_POLY_TRACE_LEVEL
+#define MV_POLY_TRACE_LEVEL MV_POLY_TRACE_SUMMARY
+#endif
+
+/// Constant expression: messages of the \c level are compiled in.
+#define MV_POLY_TRACE_ENABLED(level) ((level) <= MV_POLY_TRACE_LEVEL)
+
+/// LOG(INFO) of the given level (cf. MV_POLY_TRACE_SUMMARY and others).
+#define MV_POLY_LOG(level) LOG_IF(INFO, MV_POLY_TRACE_ENABLED(level))
+
+/// LOG_IF(INFO, cond) of the given level, \c cond isn't evaluated if disabled.
+#define MV_POLY_LOG_IF(level, cond) \
+    LOG_IF(INFO, MV_POLY_TRACE_ENABLED(level) && (cond))
+
+#endif /* TRACE_HPP_ */
@@ -36,6 +36,7 @@ std::string mapToStr(M const & m) {
         oss
               << pr.first  << " : "
               << pr.second << " ";
+    return oss.str();
 }
 
 } // namespace mv_poly
@@ -0,0 +1,658 @@
+/**
+ * @file bmsa-batch.hpp
+ *
+ * BMS-algorithm run for a batch of sequences of the same length (e.g.
+ * syndromes of several received words of one code) at once.
+ *
+ * The control flow of a step of BMS-algorithm (new delta-set, which
+ * polynomials of new F come by deg bump and which by Berlekamp formula,
+ * what goes to new G) depends only on F, G, the delta-set and on which of
+ * the discrepancies are zero. So the sequences of a batch share that
+ * control flow, and their coefficients are stored side by side (as lanes,
+ * structure-of-arrays) so that every arithmetic operation is a tight loop
+ * over the lanes. When discrepancies of some lanes turn zero and of the
+ * others don't, the staircases diverge and the batch is split into
+ * sub-batches, each continuing on its own. The staircases of words with
+ * the same number of errors tend to converge again, so the sub-batches
+ * whose delta-sets become equal are merged back after every step. The
+ * sequences stay in one box shared by all the sub-batches, so neither
+ * split nor merge copies them.
+ */
+
+#ifndef BMSA_BATCH_HPP_
+#define BMSA_BATCH_HPP_
+
+#include <algorithm>
+#include <iterator>
+#include <list>
+#include <utility>
+#include <vector>
+
+#include <glog/logging.h>
+
+#include "mv_poly.hpp"
+#include "Point.hpp"
+#include "CoefficientTraits.hpp"
+#include "SequenceView.hpp"
+#include "DenseSequence.hpp"
+#include "FlatMap.hpp"
+#include "Trace.hpp"
+
+namespace mv_poly {
+
+/**
+ * \class BatchedBMSAlgorithm
+ * Computes minimal sets of polynomials for every sequence of a batch; the
+ * result for a sequence is the same as BMSAlgorithm gives for it. As with
+ * BMSAlgorithm::step, the sequences can be extended as their elements
+ * become known (e.g. syndromes found by majority voting).
+ *
+ * @param Dim Dimension of point lattice.
+ * @param Coef Sequence element type (a field).
+ * @param OrderPolicy Monomial order.
+ */
+template<
+    int Dim,
+    typename Coef,
+    template <typename PointImpl> class OrderPolicy = GradedAntilexMonomialOrder
+>
+class BatchedBMSAlgorithm {
+public:
+    typedef Point<Dim, OrderPolicy> PointT;
+
+    typedef typename MVPolyType<Dim, Coef>::type PolynomialT;
+
+    typedef std::list< PolynomialT > PolynomialCollection;
+
+    typedef std::list< PointT > PointCollection;
+
+    /// Polynomials paired with their points (cf. currentF, currentG).
+    typedef std::vector< std::pair<PointT, PolynomialT> > PointPolynomialCollection;
+
+    /**
+     * Copies the sequences into the lanes of the batch. Every sequence is
+     * read at the points enumerated by the order up to \c seqLen_.
+     * @param seqs Sequences of any type \c getSequenceElement accepts
+     * (maps, polynomials, DenseSequence).
+     * @param seqLen_ Point next to the last one to process.
+     */
+    template<typename SeqT>
+    BatchedBMSAlgorithm(std::vector<SeqT> const & seqs, PointT const & seqLen_) :
+            ZERO(CoefficientTraits<Coef>::addId()), seqLen(seqLen_),
+            width(seqs.size()), splitCnt(0), mergeCnt(0) {
+        typename BoxLayout<Dim>::Extents extents;
+        extents.fill(0);
+        for (PointT pt; pt < seqLen; ++pt)
+            if (pt.isCanonical())
+                for (int i = 0; i < Dim; ++i)
+                    if (extents[i] <= pt[i])
+                        extents[i] = pt[i] + 1;
+        layout = BoxLayout<Dim>(extents);
+        if (width == 0)
+            return;
+
+        SubBatch all;
+        for (size_t j = 0; j < width; ++j)
+            all.lanes.push_back(j);
+        seq.assign(layout.size() * width, ZERO);
+        for (PointT pt; pt < seqLen; ++pt)
+            if (pt.isCanonical()) {
+                Coef * lane = &seq[layout.rank(pt) * width];
+                for (size_t j = 0; j < width; ++j)
+                    lane[j] = getSequenceElement(seqs[j], pt);
+            }
+        LanePolynomial one;
+        one.degs.push_back(PointT());
+        one.coefs.assign(width, CoefficientTraits<Coef>::multId());
+        all.F.push_back(PointT(), std::move(one));
+        batches.push_back(std::move(all));
+    }
+
+    /**
+     * Runs the algorithm for all the sequences (resuming from the point
+     * where the previous call or step stopped).
+     * @return Minimal sets (in the order of the sequences in the batch).
+     */
+    std::vector<PolynomialCollection> computeMinimalSets() {
+        for (; curPoint < seqLen; ++curPoint)
+            stepAll(curPoint);
+        MV_POLY_LOG(MV_POLY_TRACE_SUMMARY)
+                << "batched bmsa: " << width << " sequences, "
+                << batches.size() << " sub-batches after "
+                << splitCnt << " splits and " << mergeCnt << " merges";
+        return current();
+    }
+
+    /**
+     * Sets the elements at \c pt of all the sequences, e.g. to compute
+     * discrepancies (cf. getDiscrepancies) for the candidate values of
+     * unknown elements.
+     * @param values Elements in the order of the sequences in the batch.
+     */
+    void setSequenceElements(PointT const & pt, std::vector<Coef> const & values) {
+        reserve(pt);
+        std::copy(values.begin(), values.end(), &seq[layout.rank(pt) * width]);
+    }
+
+    /**
+     * Feeds the next elements of the sequences (cf. BMSAlgorithm::step):
+     * stores them at nextPoint() and makes one step for all the sequences.
+     * @param values Elements in the order of the sequences in the batch.
+     */
+    void step(std::vector<Coef> const & values) {
+        setSequenceElements(curPoint, values);
+        stepAll(curPoint);
+        ++curPoint;
+        if (seqLen < curPoint)
+            seqLen = curPoint;
+    }
+
+    /// Minimal sets for the part of the sequences processed so far.
+    std::vector<PolynomialCollection> current() const {
+        std::vector<PolynomialCollection> result(width);
+        for (typename std::list<SubBatch>::const_iterator it = batches.begin();
+                it != batches.end(); ++it)
+            for (size_t j = 0; j < it->lanes.size(); ++j)
+                result[it->lanes[j]] = getPolynomialList(it->F, j, it->lanes.size());
+        return result;
+    }
+
+    /// F of every sequence with the degrees (cf. BMSAlgorithm::getF).
+    std::vector<PointPolynomialCollection> currentF() const {
+        return getPointPolynomials(&SubBatch::F);
+    }
+
+    /**
+     * G of every sequence with the maximal points of the delta-set (cf.
+     * BMSAlgorithm::getG).
+     */
+    std::vector<PointPolynomialCollection> currentG() const {
+        return getPointPolynomials(&SubBatch::G);
+    }
+
+    /// Point of the sequence elements the next step expects.
+    PointT const & nextPoint() const {
+        return curPoint;
+    }
+
+    /// Indices of the sequences of the \c i-th sub-batch.
+    std::vector<size_t> const & getLanes(size_t i) const {
+        return getSubBatch(i).lanes;
+    }
+
+    /// Degrees of F of the \c i-th sub-batch (following the monomial order).
+    std::vector<PointT> getDegrees(size_t i) const {
+        std::vector<PointT> result;
+        PointPolyMap const & F = getSubBatch(i).F;
+        for (typename PointPolyMap::const_iterator it = F.begin(); it != F.end(); ++it)
+            result.push_back(it->first);
+        return result;
+    }
+
+    /// Delta-set (maximal points) of the \c i-th sub-batch.
+    PointCollection const & getDeltaPoints(size_t i) const {
+        return getSubBatch(i).oldDeltaPoints;
+    }
+
+    /**
+     * <tt>conv(f, u, deg f, k)</tt> for every f in F of the \c i-th
+     * sub-batch and every its lane (zero if deg f isn't below \c k).
+     * @return Discrepancies, the ones of the lanes for an f are contiguous
+     * (f-th of getDegrees at <tt>[f * getLanes(i).size()]</tt>).
+     */
+    std::vector<Coef> getDiscrepancies(size_t i, PointT const & k) const {
+        SubBatch const & b = getSubBatch(i);
+        std::vector<Coef> result(b.F.size() * b.lanes.size(), ZERO);
+        size_t f = 0;
+        for (typename PointPolyMap::const_iterator it = b.F.begin();
+                it != b.F.end(); ++it, ++f)
+            if (byCoordinateLess(it->first, k))
+                addDiscrepancies(b, it->first, it->second, k,
+                        &result[f * b.lanes.size()]);
+        return result;
+    }
+
+    /// Number of sequences in the batch.
+    size_t getWidth() const { return width; }
+
+    /// Number of groups of sequences sharing the control flow at the moment.
+    size_t getSubBatchCnt() const { return batches.size(); }
+
+    /// How many times a sub-batch was split because of diverged staircases.
+    unsigned long getSplitCnt() const { return splitCnt; }
+
+    /// How many times two sub-batches were merged as their staircases met.
+    unsigned long getMergeCnt() const { return mergeCnt; }
+
+    PointT const & getSeqLen() const { return seqLen; }
+
+private:
+    /// One step at \c k for all the sub-batches.
+    void stepAll(PointT const & k) {
+        for (typename std::list<SubBatch>::iterator it = batches.begin();
+                it != batches.end(); ) {
+            std::list<SubBatch> stepped = infoUpdate(*it, k);
+            batches.splice(it, stepped);
+            it = batches.erase(it);
+        }
+        mergeSubBatches();
+    }
+
+    /// Grows the box of the sequences to contain \c pt.
+    void reserve(PointT const & pt) {
+        if (layout.contains(pt))
+            return;
+        typename BoxLayout<Dim>::Extents extents = layout.getExtents();
+        for (int i = 0; i < Dim; ++i)
+            if (extents[i] <= pt[i])
+                extents[i] = std::max(2 * extents[i], pt[i] + 1);
+        BoxLayout<Dim> const newLayout(extents);
+        PointT p;
+        std::vector<Coef> newSeq(newLayout.size() * width, ZERO);
+        for (long r = 0; r < layout.size(); ++r) {
+            layout.unrank(r, p);
+            std::copy(&seq[r * width], &seq[r * width] + width,
+                    &newSeq[newLayout.rank(p) * width]);
+        }
+        seq.swap(newSeq);
+        layout = newLayout;
+    }
+
+    /**
+     * Polynomial with coefficients in all lanes of a sub-batch: the terms are
+     * sorted by coordinates (not by the monomial order, which isn't total for
+     * weighted orders on non-canonical points), the coefficients of a term
+     * for all the lanes are contiguous.
+     */
+    struct LanePolynomial {
+        std::vector<PointT> degs;
+
+        std::vector<Coef> coefs; // degs.size() * lane count
+    };
+
+    typedef FlatMap< PointT, LanePolynomial > PointPolyMap;
+
+    /// Sequences sharing the control flow of the algorithm.
+    struct SubBatch {
+        /// Indices of the sequences in the batch (their lanes in \c seq).
+        std::vector<size_t> lanes;
+
+        PointPolyMap F;
+
+        PointPolyMap G;
+
+        PointCollection oldDeltaPoints;
+    };
+
+    SubBatch const & getSubBatch(size_t i) const {
+        typename std::list<SubBatch>::const_iterator it = batches.begin();
+        std::advance(it, i);
+        return *it;
+    }
+
+    static bool coordinatesLess(PointT const & lhs, PointT const & rhs) {
+        for (int i = 0; i < Dim; ++i)
+            if (lhs[i] != rhs[i])
+                return lhs[i] < rhs[i];
+        return false;
+    }
+
+    /**
+     * Adds <tt>conv(f, u, degF, k)</tt> for every lane of \c b to \c out:
+     * only the terms of f which \c conv visits (cf. SupportTerms) are read.
+     */
+    void addDiscrepancies(
+            SubBatch const & b,
+            PointT const & degF,
+            LanePolynomial const & f,
+            PointT const & k,
+            Coef * out) const {
+        size_t const w = b.lanes.size();
+        PointT const shift = k - degF;
+        for (size_t t = 0; t < f.degs.size(); ++t) {
+            PointT const & deg = f.degs[t];
+            if (!deg.isCanonical() || !(deg <= degF))
+                continue;
+            PointT const pt = deg + shift;
+            if (!layout.contains(pt))
+                continue;
+            Coef const * c = &f.coefs[t * w];
+            Coef const * u = &seq[layout.rank(pt) * width];
+            for (size_t j = 0; j < w; ++j)
+                out[j] += c[j] * u[b.lanes[j]];
+        }
+    }
+
+    /// x^u * f (the order of the terms is kept).
+    static void shiftPolynomial(LanePolynomial & f, PointT const & u) {
+        for (size_t t = 0; t < f.degs.size(); ++t)
+            f.degs[t] += u;
+    }
+
+    /**
+     * Berlekamp formula <tt>x^u * f - d * x^v * g</tt> with the
+     * discrepancy d taken per lane. Terms zero in all lanes are dropped.
+     */
+    void combine(
+            LanePolynomial const & f, PointT const & u,
+            LanePolynomial const & g, PointT const & v,
+            Coef const * d, size_t w,
+            LanePolynomial & result) const {
+        result.degs.clear();
+        result.coefs.clear();
+        size_t i = 0, l = 0;
+        while (i < f.degs.size() || l < g.degs.size()) {
+            PointT const fDeg = i < f.degs.size() ? f.degs[i] + u : PointT();
+            PointT const gDeg = l < g.degs.size() ? g.degs[l] + v : PointT();
+            bool const fromF = i < f.degs.size()
+                    && (l == g.degs.size() || !coordinatesLess(gDeg, fDeg));
+            bool const fromG = l < g.degs.size()
+                    && (i == f.degs.size() || !coordinatesLess(fDeg, gDeg));
+            size_t const base = result.coefs.size();
+            result.coefs.resize(base + w, ZERO);
+            Coef * out = &result.coefs[base];
+            if (fromF)
+                std::copy(&f.coefs[i * w], &f.coefs[i * w] + w, out);
+            if (fromG) {
+                Coef const * c = &g.coefs[l * w];
+                for (size_t j = 0; j < w; ++j)
+                    out[j] -= d[j] * c[j];
+            }
+            if (std::count(out, out + w, ZERO) == (long)w)
+                result.coefs.resize(base);
+            else
+                result.degs.push_back(fromF ? fDeg : gDeg);
+            if (fromF)
+                ++i;
+            if (fromG)
+                ++l;
+        }
+    }
+
+    /// Sub-batch of the lanes \c lanes (local indices) of \c b.
+    static SubBatch selectLanes(SubBatch const & b, std::vector<size_t> const & lanes) {
+        size_t const w = b.lanes.size(), n = lanes.size();
+        SubBatch result;
+        for (size_t j = 0; j < n; ++j)
+            result.lanes.push_back(b.lanes[lanes[j]]);
+        PointPolyMap const * from[] = { &b.F, &b.G };
+        PointPolyMap * to[] = { &result.F, &result.G };
+        for (int m = 0; m < 2; ++m)
+            for (typename PointPolyMap::const_iterator it = from[m]->begin();
+                    it != from[m]->end(); ++it) {
+                LanePolynomial p;
+                p.degs = it->second.degs;
+                for (size_t t = 0; t < p.degs.size(); ++t)
+                    for (size_t j = 0; j < n; ++j)
+                        p.coefs.push_back(it->second.coefs[t * w + lanes[j]]);
+                to[m]->push_back(it->first, std::move(p));
+            }
+        result.oldDeltaPoints = b.oldDeltaPoints;
+        return result;
+    }
+
+    /**
+     * Merges the sub-batches with equal delta-sets: the degrees of F and G
+     * are determined by the delta-set, so their lanes share the control
+     * flow again (until the discrepancies differ).
+     */
+    void mergeSubBatches() {
+        for (typename std::list<SubBatch>::iterator it = batches.begin();
+                it != batches.end(); ++it) {
+            typename std::list<SubBatch>::iterator other = it;
+            for (++other; other != batches.end(); ) {
+                if (sameDegrees(it->G, other->G) && sameDegrees(it->F, other->F)) {
+                    mergeInto(*it, *other);
+                    other = batches.erase(other);
+                    ++mergeCnt;
+                } else {
+                    ++other;
+                }
+            }
+        }
+    }
+
+    static bool sameDegrees(PointPolyMap const & lhs, PointPolyMap const & rhs) {
+        if (lhs.size() != rhs.size())
+            return false;
+        for (typename PointPolyMap::const_iterator l = lhs.begin(), r = rhs.begin();
+                l != lhs.end(); ++l, ++r)
+            if (!(l->first == r->first))
+                return false;
+        return true;
+    }
+
+    /// Appends the lanes of \c other to \c b (both have the same degrees).
+    void mergeInto(SubBatch & b, SubBatch const & other) const {
+        size_t const w = b.lanes.size(), ow = other.lanes.size();
+        PointPolyMap * to[] = { &b.F, &b.G };
+        PointPolyMap const * from[] = { &other.F, &other.G };
+        for (int m = 0; m < 2; ++m) {
+            typename PointPolyMap::const_iterator fromIt = from[m]->begin();
+            for (typename PointPolyMap::iterator it = to[m]->begin();
+                    it != to[m]->end(); ++it, ++fromIt) {
+                LanePolynomial merged;
+                mergeLanes(it->second, w, fromIt->second, ow, merged);
+                it->second = std::move(merged);
+            }
+        }
+        b.lanes.insert(b.lanes.end(), other.lanes.begin(), other.lanes.end());
+    }
+
+    /**
+     * Polynomial with the lanes of \c f (\c w of them) followed by the
+     * lanes of \c g (\c gw): the terms are the union of theirs, zero in
+     * the lanes of the polynomial a term is absent from.
+     */
+    void mergeLanes(
+            LanePolynomial const & f, size_t w,
+            LanePolynomial const & g, size_t gw,
+            LanePolynomial & result) const {
+        size_t i = 0, l = 0;
+        while (i < f.degs.size() || l < g.degs.size()) {
+            bool const fromF = i < f.degs.size()
+                    && (l == g.degs.size() || !coordinatesLess(g.degs[l], f.degs[i]));
+            bool const fromG = l < g.degs.size()
+                    && (i == f.degs.size() || !coordinatesLess(f.degs[i], g.degs[l]));
+            result.degs.push_back(fromF ? f.degs[i] : g.degs[l]);
+            size_t const base = result.coefs.size();
+            result.coefs.resize(base + w + gw, ZERO);
+            if (fromF)
+                std::copy(&f.coefs[i * w], &f.coefs[i * w] + w, &result.coefs[base]);
+            if (fromG)
+                std::copy(&g.coefs[l * gw], &g.coefs[l * gw] + gw,
+                        &result.coefs[base + w]);
+            if (fromF)
+                ++i;
+            if (fromG)
+                ++l;
+        }
+    }
+
+    /**
+     * One step of the algorithm for the sub-batch \c b.
+     * @return The sub-batch after the step or the sub-batches it was split
+     * into.
+     */
+    std::list<SubBatch> infoUpdate(SubBatch & b, PointT const & k) {
+        size_t const w = b.lanes.size();
+        std::vector<PointT> spanning;
+        for (typename PointPolyMap::const_iterator it = b.F.begin();
+                it != b.F.end(); ++it)
+            if (byCoordinateLess(it->first, k))
+                spanning.push_back(it->first);
+        std::vector<Coef> discr(spanning.size() * w, ZERO);
+        for (size_t i = 0; i < spanning.size(); ++i)
+            addDiscrepancies(b, spanning[i], b.F.find(spanning[i])->second, k,
+                    &discr[i * w]);
+
+        // group the lanes by the pattern of zero discrepancies
+        std::vector< std::vector<bool> > patterns;
+        std::vector< std::vector<size_t> > groups;
+        for (size_t j = 0; j < w; ++j) {
+            std::vector<bool> pattern(spanning.size());
+            for (size_t i = 0; i < spanning.size(); ++i)
+                pattern[i] = discr[i * w + j] != ZERO;
+            size_t g = std::find(patterns.begin(), patterns.end(), pattern)
+                    - patterns.begin();
+            if (g == patterns.size()) {
+                patterns.push_back(pattern);
+                groups.push_back(std::vector<size_t>());
+            }
+            groups[g].push_back(j);
+        }
+
+        std::list<SubBatch> result;
+        if (groups.size() == 1) {
+            update(b, k, spanning, patterns[0], discr);
+            result.push_back(std::move(b));
+            return result;
+        }
+        splitCnt += groups.size() - 1;
+        for (size_t g = 0; g < groups.size(); ++g) {
+            SubBatch part = selectLanes(b, groups[g]);
+            std::vector<Coef> partDiscr;
+            for (size_t i = 0; i < spanning.size(); ++i)
+                for (size_t j = 0; j < groups[g].size(); ++j)
+                    partDiscr.push_back(discr[i * w + groups[g][j]]);
+            update(part, k, spanning, patterns[g], partDiscr);
+            result.push_back(std::move(part));
+        }
+        return result;
+    }
+
+    /**
+     * Forms new F and G of \c b as BMSAlgorithm::infoUpdate does, all the
+     * lanes having the same zero discrepancies (\c nonzero).
+     */
+    void update(
+            SubBatch & b,
+            PointT const & k,
+            std::vector<PointT> const & spanning,
+            std::vector<bool> const & nonzero,
+            std::vector<Coef> const & discr) const {
+        size_t const w = b.lanes.size();
+        std::vector<PointT> gDegs;
+        for (typename PointPolyMap::const_iterator it = b.G.begin();
+                it != b.G.end(); ++it)
+            gDegs.push_back(it->first);
+
+        PointCollection deltaPoints;
+        for (size_t i = 0; i < spanning.size(); ++i) {
+            PointT const c = k - spanning[i];
+            if (nonzero[i] && !byCoordinateLessThenAny(c, gDegs))
+                deltaPoints.push_back(c);
+        }
+        deltaPoints.splice(deltaPoints.end(), b.oldDeltaPoints);
+        deltaPoints = getPartialMaximums(deltaPoints);
+        PointCollection const sigmaPoints = getConjugatePointCollection(deltaPoints);
+
+        // forming new F
+        PointPolyMap newF;
+        for (typename PointCollection::const_iterator tIt = sigmaPoints.begin();
+                tIt != sigmaPoints.end(); ++tIt) {
+            PointT const & t = *tIt;
+            typename PointPolyMap::const_iterator fIt = b.F.begin();
+            while (fIt != b.F.end() && !byCoordinateLess(fIt->first, t))
+                ++fIt;
+            CHECK(fIt != b.F.end())
+                << "CRITICAL: supporting f absent for given t: " << t;
+            PointT const u = t - fIt->first;
+            typename PointPolyMap::const_iterator cIt = b.G.end();
+            if (byCoordinateLess(t, k))
+                for (cIt = b.G.begin(); cIt != b.G.end(); ++cIt)
+                    if (byCoordinateLess(k - t, cIt->first))
+                        break;
+            LanePolynomial & f = newF[t];
+            if (cIt != b.G.end()) {
+                size_t const s = std::lower_bound(spanning.begin(), spanning.end(),
+                        fIt->first) - spanning.begin();
+                combine(fIt->second, u, cIt->second, cIt->first - (k - t),
+                        &discr[s * w], w, f);
+            } else {
+                f = fIt->second;
+                shiftPolynomial(f, u);
+            }
+        }
+
+        // forming new G
+        PointPolyMap newG;
+        for (typename PointCollection::const_iterator cIt = deltaPoints.begin();
+                cIt != deltaPoints.end(); ++cIt) {
+            typename PointPolyMap::iterator gIt = b.G.find(*cIt);
+            if (gIt != b.G.end()) {
+                newG.insert(std::move(*gIt));
+            } else {
+                PointT const s = k - *cIt;
+                size_t const i = std::lower_bound(spanning.begin(), spanning.end(), s)
+                        - spanning.begin();
+                LanePolynomial & g = newG[*cIt] = std::move(b.F.find(s)->second);
+                std::vector<Coef> inverse(w);
+                for (size_t j = 0; j < w; ++j)
+                    inverse[j] = CoefficientTraits<Coef>::multInverse(discr[i * w + j]);
+                for (size_t t = 0; t < g.degs.size(); ++t)
+                    for (size_t j = 0; j < w; ++j)
+                        g.coefs[t * w + j] *= inverse[j];
+            }
+        }
+
+        b.F.swap(newF);
+        b.G.swap(newG);
+        b.oldDeltaPoints.swap(deltaPoints);
+    }
+
+    PolynomialCollection getPolynomialList(
+            PointPolyMap const & F, size_t lane, size_t w) const {
+        PolynomialCollection result;
+        for (typename PointPolyMap::const_iterator it = F.begin(); it != F.end(); ++it)
+            result.push_back(getLanePolynomial(it->second, lane, w));
+        return result;
+    }
+
+    static PolynomialT getLanePolynomial(
+            LanePolynomial const & f, size_t lane, size_t w) {
+        PolynomialT p;
+        for (size_t t = 0; t < f.degs.size(); ++t)
+            setCoefficient(p, f.degs[t], f.coefs[t * w + lane]);
+        return p;
+    }
+
+    /// Polynomials of \c polys (F or G) of every sub-batch split by lanes.
+    std::vector<PointPolynomialCollection>
+    getPointPolynomials(PointPolyMap SubBatch::* polys) const {
+        std::vector<PointPolynomialCollection> result(width);
+        for (typename std::list<SubBatch>::const_iterator it = batches.begin();
+                it != batches.end(); ++it) {
+            PointPolyMap const & m = (*it).*polys;
+            for (size_t j = 0; j < it->lanes.size(); ++j)
+                for (typename PointPolyMap::const_iterator pIt = m.begin();
+                        pIt != m.end(); ++pIt)
+                    result[it->lanes[j]].push_back(std::make_pair(pIt->first,
+                            getLanePolynomial(pIt->second, j, it->lanes.size())));
+        }
+        return result;
+    }
+
+    const Coef ZERO;
+
+    PointT seqLen;
+
+    PointT curPoint; // the next step is made for curPoint
+
+    BoxLayout<Dim> layout;
+
+    size_t width;
+
+    unsigned long splitCnt;
+
+    unsigned long mergeCnt;
+
+    /// Elements of all the sequences in the box layout, width per point.
+    std::vector<Coef> seq;
+
+    std::list<SubBatch> batches;
+};
+
+} // namespace mv_poly
+
+#endif /* BMSA_BATCH_HPP_ */
@@ -0,0 +1,139 @@
+/**
+ * @file bmsa-decoding-pipeline.hpp
+ *
+ * Decoding of a stream of words by the stages of BMSDecoding run in a
+ * Pipeline.
+ */
+
+#ifndef BMSA_DECODING_PIPELINE_HPP_
+#define BMSA_DECODING_PIPELINE_HPP_
+
+#include <iostream>
+#include <utility>
+
+#include <cstddef>
+
+#include "Pipeline.hpp"
+#include "bmsa-decoding.hpp"
+
+namespace mv_poly {
+
+/**
+ * \class BMSDecodingPipeline
+ * Decodes the words pushed into it the same way BMSDecoding::decode does,
+ * but with every stage of decoding (syndromes, BMS-algorithm with
+ * majority voting, root search, error values) run by threads of its own,
+ * so the words of a stream are decoded on several cores at once. The
+ * stages share the decoder, which doesn't change while decoding.
+ *
+ * Pushing blocks while the first stage is behind (backpressure), the
+ * corrected words come out in no particular order with the indices they
+ * were pushed with.
+ */
+template<
+    int Dim,
+    typename ECCodeParams
+>
+class BMSDecodingPipeline {
+public:
+    typedef BMSDecoding<Dim, ECCodeParams> DecoderT;
+
+    typedef typename DecoderT::FieldElemsCollection FieldElemsCollection;
+
+    typedef typename Pipeline<int>::ThreadInit ThreadInit;
+
+    /// Number of threads of every stage.
+    struct StageThreads {
+        unsigned syndromes;
+
+        unsigned bmsa;
+
+        unsigned roots;
+
+        unsigned values;
+
+        /// BMS-algorithm takes most of the time, so it gets the most threads.
+        StageThreads(unsigned syndromes_ = 1, unsigned bmsa_ = 2,
+                unsigned roots_ = 1, unsigned values_ = 1) :
+                    syndromes(syndromes_), bmsa(bmsa_), roots(roots_),
+                    values(values_) {}
+    };
+
+    /**
+     * Starts the stages.
+     * @param decoder_ Decoder the stages run, it has to outlive the pipeline.
+     * @param capacity Capacity of the queues between the stages.
+     * @param threadInit Called by every thread of the stages first (e.g.
+     * to restore the NTL context, cf. Pipeline).
+     */
+    BMSDecodingPipeline(
+            DecoderT const & decoder_,
+            StageThreads const & threads = StageThreads(),
+            size_t capacity = 64,
+            ThreadInit const & threadInit = ThreadInit()) :
+                decoder(decoder_), pipeline(capacity, threadInit) {
+        DecoderT const & d = decoder;
+        pipeline.addStage("syndromes",
+                [&d](Item & item) { d.runSyndromeStage(item.second); },
+                threads.syndromes);
+        pipeline.addStage("bmsa",
+                [&d](Item & item) { d.runLocatorStage(item.second); },
+                threads.bmsa);
+        pipeline.addStage("roots",
+                [&d](Item & item) { d.runRootStage(item.second); },
+                threads.roots);
+        pipeline.addStage("values",
+                [&d](Item & item) { d.runValueStage(item.second); },
+                threads.values);
+        pipeline.start();
+    }
+
+    /// Pushes the received word \c r with \c index, fails after \c close.
+    bool push(size_t index, FieldElemsCollection r) {
+        Item item;
+        item.first = index;
+        item.second.received = std::move(r);
+        return pipeline.push(std::move(item));
+    }
+
+    /**
+     * Takes the next corrected word and the index it was pushed with,
+     * waiting for it; fails once the pipeline is closed and empty. If
+     * decoding the word has thrown, the exception is rethrown with \c index
+     * set.
+     */
+    bool pop(size_t & index, FieldElemsCollection & corrected) {
+        Item item;
+        try {
+            if (!pipeline.pop(item))
+                return false;
+        } catch (...) {
+            index = item.first;
+            throw;
+        }
+        index = item.first;
+        corrected = std::move(item.second.corrected);
+        return true;
+    }
+
+    /// No more words: the ones pushed are decoded and can still be popped.
+    void close() {
+        pipeline.close();
+    }
+
+    /// Latency histograms of the pipeline and of its stages (cf. Pipeline::writeJson).
+    void writeJson(std::ostream & os) const {
+        pipeline.writeJson(os);
+    }
+
+private:
+    typedef std::pair<size_t, typename DecoderT::DecodingJob> Item;
+
+    DecoderT const & decoder;
+
+    Pipeline<Item> pipeline;
+};
+
+} // namespace mv_poly
+
+#endif /* BMSA_DECODING_PIPELINE_HPP_ */
@@ -8,12 +8,15 @@
 #ifndef BMSA_DECODING_HPP_
 #define BMSA_DECODING_HPP_
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <functional>
 #include <map>
+#include <memory>
+#include <numeric>
 #include <vector>
 
-#include <boost/iterator/transform_iterator.hpp>
 #include <boost/range/adaptor/map.hpp>
 #include <boost/range/iterator_range.hpp>
 
@@ -21,12 +24,147 @@
 
 #include "Point.hpp"
 #include "bmsa.hpp"
+#include "bmsa-batch.hpp"
 #include "mv_poly.hpp"
 #include "CurveArithmetic.hpp"
+#include "CodeContext.hpp"
+#include "MatrixProduct.hpp"
+#include "DenseSequence.hpp"
 #include "NtlPolynomials.hpp"
+#include "Trace.hpp"
+#include "PerfCounters.hpp"
 
 namespace mv_poly {
 
+/**
+ * Delta-set of BMS-algorithm as a staircase of column heights, used to find
+ * the voters of Feng-Rao majority voting. A column is the line of points
+ * that differ in the last coordinate only; as the delta-set is closed
+ * downwards, it holds the points of a column below its height. The
+ * delta-set only grows from step to step, so the heights are raised by the
+ * boxes of its new maximal points instead of being rebuilt, and a point is
+ * checked in O(1).
+ */
+template<typename PointT>
+class DeltaSetGrid {
+public:
+    DeltaSetGrid() : heights(columns.size(), 0) {
+    }
+
+    /// Adds the boxes of the maximal points that are not in the grid yet.
+    template<typename PointRange>
+    void update(PointRange const & maxPoints) {
+        for (auto it = maxPoints.begin(); it != maxPoints.end(); ++it)
+            if (!contains(*it))
+                addBox(*it);
+    }
+
+    bool contains(PointT const & pt) const {
+        return pt[Last] < height(pt);
+    }
+
+    /**
+     * Counts the voters at \c k: the points q below \c k (by coordinates)
+     * such that q and k - q are both outside of the delta-set and both are
+     * basis elements of the code. Every voter is given to the first of
+     * \c degs (the degrees of F) below it.
+     *
+     * Only the voters are visited: in the column of q they are the points
+     * from the height of the column up to the last coordinate of k less the
+     * height of the column of k - q. The first degree below q changes along
+     * the column only at the last coordinates of the degrees, which are
+     * sorted once per column.
+     * @param isBasisElem Predicate on points.
+     * @param votes Votes per degree, incremented.
+     */
+    template<typename Predicate>
+    void countVotes(
+            std::vector<PointT> const & degs,
+            PointT const & k,
+            Predicate const & isBasisElem,
+            std::vector<unsigned> & votes) const {
+        typename Columns::Extents extents;
+        for (int i = 0; i < Last; ++i)
+            extents[i] = k[i] + 1;
+        Columns const box(extents);
+        PointT q, rest;
+        std::vector< std::pair<long, size_t> > owners;
+        for (long r = 0; r < box.size(); ++r) {
+            box.unrank(r, q);
+            for (int i = 0; i < Last; ++i)
+                rest[i] = k[i] - q[i];
+            long const top = k[Last] - height(rest);
+            // the degrees below the column, by the last coordinate
+            owners.clear();
+            for (size_t i = 0; i < degs.size(); ++i)
+                if (byCoordinateLess(degs[i], q, Last))
+                    owners.push_back(std::make_pair(long(degs[i][Last]), i));
+            std::sort(owners.begin(), owners.end());
+            size_t next = 0, owner = degs.size();
+            for (long c = height(q); c <= top; ++c) {
+                for (; next < owners.size() && owners[next].first <= c; ++next)
+                    owner = std::min(owner, owners[next].second);
+                q[Last] = c;
+                rest[Last] = k[Last] - c;
+                if (owner < degs.size() && isBasisElem(q) && isBasisElem(rest))
+                    ++votes[owner];
+            }
+        }
+    }
+
+private:
+    static const int Last = PointT::DIM - 1;
+
+    /// Layout of the columns, by the first coordinates of their points.
+    typedef BoxLayout<Last> Columns;
+
+    /// Height of the column of \c pt, 0 outside of the grid.
+    long height(PointT const & pt) const {
+        return columns.contains(pt) ? heights[columns.rank(pt)] : 0;
+    }
+
+    /// Whether \c a is below \c b by the first \c n coordinates.
+    static bool byCoordinateLess(PointT const & a, PointT const & b, int n) {
+        for (int i = 0; i < n; ++i)
+            if (b[i] < a[i])
+                return false;
+        return true;
+    }
+
+    void addBox(PointT const & c) {
+        if (!columns.contains(c)) {
+            typename Columns::Extents extents = columns.getExtents();
+            for (int i = 0; i < Last; ++i)
+                if (extents[i] <= c[i])
+                    extents[i] = std::max(2 * extents[i], long(c[i]) + 1);
+            Columns const newColumns(extents);
+            std::vector<long> newHeights(newColumns.size(), 0);
+            PointT pt;
+            for (long r = 0; r < (long)heights.size(); ++r) {
+                columns.unrank(r, pt);
+                newHeights[newColumns.rank(pt)] = heights[r];
+            }
+            columns = newColumns;
+            heights.swap(newHeights);
+        }
+        typename Columns::Extents extents;
+        for (int i = 0; i < Last; ++i)
+            extents[i] = c[i] + 1;
+        Columns const box(extents);
+        PointT pt;
+        for (long r = 0; r < box.size(); ++r) {
+            box.unrank(r, pt);
+            long & h = heights[columns.rank(pt)];
+            h = std::max(h, long(c[Last]) + 1);
+        }
+    }
+
+    Columns columns;
+
+    /// Column heights, by the ranks of the columns.
+    std::vector<long> heights;
+};
+
 template<
     int Dim,
     typename ECCodeParams
@@ -47,36 +185,112 @@ public:
 
     typedef std::vector<Field> FieldElemsCollection;
 
+    typedef std::vector<int> ErrorPositions;
+
+    typedef CodeContext<Dim, ECCodeParams> Context;
+
+    typedef typename ECCodeParams::LatticeOrderPolicyHolder LatticeOrderPolicyHolder;
+
+    typedef DenseSequence<Dim, Field, LatticeOrderPolicyHolder::template impl>
+        SyndromeType;
+
 private:
 
     /******************** Private typedef's *********************/
 
-    typedef std::map< BasisElem, Field> SyndromeType;
-
-    typedef typename ECCodeParams::OrderPolicyHolder OrderPolicyHolder;
+    typedef typename SyndromeType::PointT LatticePointT;
 
     typedef BMSAlgorithm< SyndromeType,
             typename MVPolyType<Dim, Field>::type,
-            OrderPolicyHolder::template impl
+            LatticeOrderPolicyHolder::template impl
         > BmsaT;
 
-    typedef typename BmsaT::PolynomialCollection PolynomialCollection;
+    typedef BatchedBMSAlgorithm< Dim, Field,
+            LatticeOrderPolicyHolder::template impl
+        > BatchedBmsaT;
 
-    typedef std::vector<int> ErrorPositions;
+    typedef typename ECCodeParams::BasisCollection BasisCollection;
+
+    typedef typename BmsaT::PolynomialCollection PolynomialCollection;
 
     /******************** Private fields *********************/
-    size_t l;
 
-    CurvePointsCollection curvePoints;
+    /// Context made by the decoder itself (cf. BMSDecoding(size_t)).
+    std::shared_ptr<Context const> ownedContext;
+
+    Context const & context;
+
+    typename BmsaT::TraceSink traceSink;
+
+#if MV_POLY_PERF_COUNTERS
+    /**
+     * Wall time (seconds) of the phases of decoding summed over the words:
+     * of one decode or, with atomic counts and AtomicSeconds, shared by
+     * concurrent decodes without locking.
+     */
+    template<typename Count, typename Seconds>
+    struct BasicDecodingCounters {
+        Count words;
+
+        Seconds syndromeTime;
+
+        Seconds bmsaTime;
+
+        Seconds locationTime;
+
+        Seconds valueTime;
+
+        BasicDecodingCounters() {
+            clear();
+        }
+
+        void clear() {
+            words = 0;
+            syndromeTime = 0;
+            bmsaTime = 0;
+            locationTime = 0;
+            valueTime = 0;
+        }
+
+        template<typename C, typename S>
+        BasicDecodingCounters & operator+=(BasicDecodingCounters<C, S> const & other) {
+            words += other.words;
+            syndromeTime += other.syndromeTime;
+            bmsaTime += other.bmsaTime;
+            locationTime += other.locationTime;
+            valueTime += other.valueTime;
+            return *this;
+        }
+    };
+
+    typedef BasicDecodingCounters<unsigned long, double> DecodingCounters;
+
+    mutable BasicDecodingCounters<std::atomic<unsigned long>, AtomicSeconds> counters;
+
+    /// Counters of BMS-algorithm summed over the words.
+    mutable SharedBmsaCounters bmsaCounters;
+
+    /**
+     * Adds the counters of one decode to the decoder ones, \c bmsaRun (if
+     * any) to the ones of BMS-algorithm. Decodes run concurrently on a
+     * shared decoder, so the totals are added atomically and only they
+     * are kept.
+     */
+    void addCounters(DecodingCounters const & run, BmsaCounters const * bmsaRun) const {
+        counters += run;
+        if (bmsaRun)
+            bmsaCounters += *bmsaRun;
+    }
+#endif
 
     // compute common roots of elements in F
     ErrorPositions
-    getErrorLocations(PolynomialCollection const & polys) {
+    getErrorLocations(PolynomialCollection const & polys) const {
         typedef typename PolynomialCollection::value_type PolyT;
         typedef CoefficientTraits<typename PolyT::CoefT> CoefTr;
         ErrorPositions result;
         int idx = 0;
-        std::for_each(curvePoints.begin(), curvePoints.end(),
+        std::for_each(context.getCurvePoints().begin(), context.getCurvePoints().end(),
                 [&result,&idx,&polys](CurvePoint const & cp) {
                     bool root_for_all = std::accumulate(polys.begin(),
                             polys.end(), true,
@@ -90,151 +304,714 @@ private:
         });
 
         // **********  logging
-        std::ostringstream log_oss;
-        std::copy(result.begin(), result.end(),
-                std::ostream_iterator<int>(log_oss, " "));
-        LOG(INFO) << "Error positions: " << log_oss.str();
+        if (MV_POLY_TRACE_ENABLED(MV_POLY_TRACE_STEPS)) {
+            std::ostringstream log_oss;
+            std::copy(result.begin(), result.end(),
+                    std::ostream_iterator<int>(log_oss, " "));
+            LOG(INFO) << "Error positions: " << log_oss.str();
+        }
         // **********  ENF OF logging
 
         return result;
     }
 
+    /**
+     * Error values at \c positions given F and G (pairs of a point and a
+     * polynomial, cf. BMSAlgorithm::getG) of BMS-algorithm run for the
+     * syndromes \c syn: Horiguchi-Koetter formula e_P = 1 / (g(P) f'(P))
+     * generalized to the delta-set of BMS-algorithm.
+     *
+     * For d in the delta-set and the first maximal point c above it the
+     * polynomial g_d = x^{c - d} g_c has S(g_d x^m) = 0 for m < d and
+     * S(g_d x^d) = 1, so the matrix M = (S(g_d x^{d'})) over the delta-set
+     * is unitriangular. If the row b(P) solves b(P) M = (P^{d'}), then
+     * sum_d g_d(P) b_d(P) = 1 / e_P, i.e. 1 / e_P = sum_c g_c(P) h_c(P)
+     * with h_c(P) = sum_d P^{c - d} b_d(P) over the d below c.
+     *
+     * This is not a closed formula: with the delta-set in one line M has no
+     * entries above the diagonal and it is the classical one, otherwise M
+     * is found once per word and every error value takes a back
+     * substitution, O(|delta|^2) per position and O(t^3) per word. What is
+     * shared is shared: an entry S(g_c x^{c - d + d'}) is convolved once
+     * per distinct exponent, and every g_c is evaluated once per position.
+     * The syndromes the entries need are extended by the recurrences of F.
+     * @return Values in the order of \c positions, empty if the word is
+     * uncorrectable (the roots of F don't match its delta-set).
+     */
+    template<typename PointPolyRangeF, typename PointPolyRangeG>
     FieldElemsCollection
     getErrorValues(
-            FieldElemsCollection const & r,
-            CurvePointsCollection const & locations) {
-        // Not Implemented Yet
-    }
-
-    // Feng-Rao majority voting: partially implemented
-    void frmv(BmsaT & bmsa) {
-        typedef std::map<PointT, PointT> PointToPointMap;
-        PointToPointMap voters; // Г_k with support points from \sigma_k attached
-        PointT k = bmsa.getSeqLen();     // k - kurrent step :)
-
-        // 1. Compute Г_k
-        for (
-             auto it = bmsa.getF().begin();
-             it != bmsa.getF().end();
-             ++it
-             ) {
-            PointT const & s = it->first;
-            for (PointT t = s; t < k; ++t) {
-                // we assume tha going from s to k following monomial order
-                // yields all points t s.t. s <= t <= k where <= stands for
-                // by-coordinate comparison (natural partial order)
-                bool l1 = byCoordinateLess(s, t);
-                bool l2 = byCoordinateLess(t, k);
-                bool g = byCoordinateGreaterThenAny(k - t, bmsa.getF() | boost::adaptors::map_keys);
-                if (
-                        l1 &&
-                        l2 &&
-                        g) {
-                    voters[t] = s;
-                }
+            SyndromeType & syn,
+            PointPolyRangeF const & F,
+            PointPolyRangeG const & G,
+            ErrorPositions const & positions) const {
+        typedef typename MVPolyType<Dim, Field>::type PolyT;
+        Field const zero = FieldElemTraits<Field>::addId();
+        FieldElemsCollection result;
+
+        // the maximal points and the delta-set, every point with the first
+        // maximal point above it
+        std::vector<PolyT const *> gs;
+        std::vector<LatticePointT> delta;
+        for (auto it = G.begin(); it != G.end(); ++it) {
+            gs.push_back(&it->second);
+            typename BoxLayout<Dim>::Extents extents;
+            for (int i = 0; i < Dim; ++i)
+                extents[i] = it->first[i] + 1;
+            BoxLayout<Dim> const box(extents);
+            LatticePointT d;
+            for (long r = 0; r < box.size(); ++r) {
+                box.unrank(r, d);
+                delta.push_back(d);
+            }
+        }
+        std::sort(delta.begin(), delta.end());
+        delta.erase(std::unique(delta.begin(), delta.end()), delta.end());
+        if (delta.size() != positions.size()) {
+            MV_POLY_LOG(MV_POLY_TRACE_SUMMARY) << "Uncorrectable word: "
+                    << positions.size() << " roots of error locators for "
+                    << delta.size() << " points of delta-set";
+            return result;
+        }
+        std::vector<size_t> corners;
+        std::vector<LatticePointT> shifts;
+        long maxWeight = 0, maxTermWeight = 0;
+        for (size_t i = 0; i < delta.size(); ++i) {
+            auto it = G.begin();
+            size_t c = 0;
+            for (; !byCoordinateLess(delta[i], it->first); ++it)
+                ++c;
+            corners.push_back(c);
+            shifts.push_back(it->first - delta[i]);
+            maxWeight = std::max(maxWeight, ECCodeParams::weight(delta[i]));
+            forEachCoefficient<LatticePointT>(it->second,
+                    [&maxTermWeight, &it, &zero](LatticePointT const & pt, Field const & c) {
+                        if (c != zero)
+                            maxTermWeight = std::max(maxTermWeight,
+                                    ECCodeParams::weight(pt + it->first));
+                    });
+        }
+        extendSyndromes(syn, F, maxTermWeight + maxWeight);
+
+        // M above the diagonal, row by row, S(g_c x^m) once per c and m
+        size_t const size = delta.size();
+        std::vector<Field> m(size * size, zero);
+        std::map<std::pair<size_t, LatticePointT>, Field> entries;
+        for (size_t i = 0; i < size; ++i)
+            for (size_t k = i + 1; k < size; ++k) {
+                LatticePointT const shift = shifts[i] + delta[k];
+                auto const inserted = entries.insert(std::make_pair(
+                        std::make_pair(corners[i], shift), zero));
+                Field & entry = inserted.first->second;
+                if (inserted.second)
+                    forEachCoefficient<LatticePointT>(*gs[corners[i]],
+                            [&entry, &syn, &shift, &zero](LatticePointT const & pt, Field const & c) {
+                                if (c != zero)
+                                    entry += c * syn[pt + shift];
+                            });
+                m[i * size + k] = entry;
+            }
+
+        std::vector<Field> b(size), hs(gs.size());
+        result.reserve(positions.size());
+        for (size_t p = 0; p < positions.size(); ++p) {
+            std::fill(hs.begin(), hs.end(), zero);
+            for (size_t k = 0; k < size; ++k) {
+                b[k] = context.monomial(delta[k], positions[p]);
+                for (size_t i = 0; i < k; ++i)
+                    b[k] -= b[i] * m[i * size + k];
+                hs[corners[k]] += b[k] * context.monomial(shifts[k], positions[p]);
+            }
+            CurvePoint const & cp = context.getCurvePoints()[positions[p]];
+            Field sum = zero;
+            for (size_t c = 0; c < gs.size(); ++c)
+                if (hs[c] != zero)
+                    sum += (*gs[c])(cp) * hs[c];
+            if (sum == zero) {
+                MV_POLY_LOG(MV_POLY_TRACE_SUMMARY) << "Uncorrectable word: "
+                        << "no error value at " << positions[p];
+                result.clear();
+                return result;
             }
+            result.push_back(CoefficientTraits<Field>::multInverse(sum));
+        }
+
+        // **********  logging
+        if (MV_POLY_TRACE_ENABLED(MV_POLY_TRACE_STEPS)) {
+            std::ostringstream log_oss;
+            for (size_t p = 0; p < result.size(); ++p)
+                log_oss << makeNtlPowerPrinter(result[p]) << " ";
+            LOG(INFO) << "Error values: " << log_oss.str();
         }
-        // **********  logging (Г_k)
-        LOG(INFO) << "Gamma_k has " << voters.size() << " elements";
-        std::ostringstream log_oss;
-        std::copy(voters.begin(), voters.end(),
-                std::ostream_iterator<typename PointToPointMap::value_type>(log_oss, " "));
-        LOG(INFO) << "Gamma_k: " << log_oss.str();
         // **********  ENF OF logging
 
+        return result;
+    }
 
-        // 2. Compute votes and choose winner
-        // Not implemented yet
+    /**
+     * \c received with the errors at \c positions subtracted, unchanged if
+     * the error values can't be found (cf. getErrorValues).
+     */
+    template<typename PointPolyRangeF, typename PointPolyRangeG>
+    FieldElemsCollection
+    correctErrors(
+            FieldElemsCollection const & received,
+            SyndromeType & syn,
+            PointPolyRangeF const & F,
+            PointPolyRangeG const & G,
+            ErrorPositions const & positions) const {
+        FieldElemsCollection result = received;
+        FieldElemsCollection const values = getErrorValues(syn, F, G, positions);
+        for (size_t p = 0; p < values.size(); ++p)
+            result[positions[p]] -= values[p];
+        return result;
     }
 
-    PolynomialCollection
-    computeErrorLocatorPolynomials(FieldElemsCollection const & received) {
-        SyndromeType syn;
-        auto basis = ECCodeParams::getCodeBasis(l);
+    /// Points of the same weight as \c k following it in the order.
+    static std::vector<LatticePointT> getPointsOfWeight(LatticePointT k) {
+        std::vector<LatticePointT> result;
+        long const w = ECCodeParams::weight(k);
+        for (; ECCodeParams::weight(k) == w; ++k)
+            result.push_back(k);
+        return result;
+    }
+
+    /**
+     * Sets the syndromes at \c points (all of the same weight, the first
+     * one is a basis element) given the syndrome \c x at the first one: the
+     * others follow by the curve equation from it and from the syndromes of
+     * lesser weight.
+     */
+    static void fillSyndromes(
+            SyndromeType & syn,
+            std::vector<LatticePointT> const & points,
+            Field const & x) {
+        syn.set(points[0], x);
+        LatticePointT same, lower;
+        for (size_t i = 1; i < points.size(); ++i) {
+            CHECK(ECCodeParams::reduceByCurve(points[i], same, lower))
+                << "CRITICAL: two basis elements of the same weight: " << points[i];
+            syn.set(points[i], syn[same] + syn[lower]);
+        }
+    }
+
+    /**
+     * Voters at \c points (all of the same weight) for the polynomials
+     * with degrees \c degs: <tt>result[j * degs.size() + i]</tt> is the
+     * number of the voters at the j-th point given to the i-th polynomial
+     * (cf. DeltaSetGrid::countVotes).
+     */
+    static std::vector<unsigned> countVotes(
+            DeltaSetGrid<LatticePointT> const & delta,
+            std::vector<LatticePointT> const & degs,
+            std::vector<LatticePointT> const & points) {
+        std::vector<unsigned> result(points.size() * degs.size(), 0);
+        std::vector<unsigned> votes;
+        for (size_t j = 0; j < points.size(); ++j) {
+            votes.assign(degs.size(), 0);
+            delta.countVotes(degs, points[j],
+                    ECCodeParams::template isBasisElem<LatticePointT>, votes);
+            std::copy(votes.begin(), votes.end(), result.begin() + j * degs.size());
+        }
+        return result;
+    }
 
+    /**
+     * The candidate value of the syndrome with the most votes. The
+     * syndromes at \c points are x + c_j, x being the one at the first
+     * point, so the discrepancy of the i-th polynomial at the j-th point is
+     * affine in x and the candidate of the polynomial is the root of it.
+     * Without votes the syndrome isn't restricted by the delta-set and
+     * follows the recurrence of the first polynomial below the first point.
+     * @param d0 Discrepancies for x = 0, <tt>[j * degs.size() + i]</tt>.
+     * @param d1 Discrepancies for x = 1.
+     * @param votes Voters (cf. countVotes).
+     */
+    static Field elect(
+            std::vector<LatticePointT> const & degs,
+            std::vector<LatticePointT> const & points,
+            std::vector<Field> const & d0,
+            std::vector<Field> const & d1,
+            std::vector<unsigned> const & votes) {
+        Field const zero = FieldElemTraits<Field>::addId();
+        std::vector< std::pair<Field, unsigned> > tally;
+        bool recurrence = false;
+        Field x = zero;
+        for (size_t j = 0; j < points.size(); ++j)
+            for (size_t i = 0; i < degs.size(); ++i) {
+                size_t const c = j * degs.size() + i;
+                Field const a = d1[c] - d0[c];
+                if (!byCoordinateLess(degs[i], points[j]) || a == zero)
+                    continue;
+                Field const candidate = zero - d0[c]
+                        * CoefficientTraits<Field>::multInverse(a);
+                if (!recurrence) {
+                    recurrence = true;
+                    x = candidate;
+                }
+                if (votes[c] == 0)
+                    continue;
+                size_t t = 0;
+                while (t < tally.size() && tally[t].first != candidate)
+                    ++t;
+                if (t == tally.size())
+                    tally.push_back(std::make_pair(candidate, 0u));
+                tally[t].second += votes[c];
+            }
+
+        unsigned best = 0;
+        for (size_t t = 0; t < tally.size(); ++t)
+            if (best < tally[t].second) {
+                best = tally[t].second;
+                x = tally[t].first;
+            }
         // **********  logging
-        std::ostringstream log_oss;
-        std::copy(basis.begin(), basis.end(),
-                std::ostream_iterator<BasisElem>(log_oss, " "));
-        LOG(INFO) << "Basis for evaluation code: " << log_oss.str();
+        if (MV_POLY_TRACE_ENABLED(MV_POLY_TRACE_STEPS)) {
+            std::ostringstream log_oss;
+            for (size_t t = 0; t < tally.size(); ++t)
+                log_oss << makeNtlPowerPrinter(tally[t].first) << ": "
+                        << tally[t].second << " ";
+            LOG(INFO) << "Votes at " << points[0] << ": " << log_oss.str();
+        }
         // **********  ENF OF logging
+        return x;
+    }
 
-        // computing "known" syndroms
-        using namespace std::placeholders;
-        auto syndromComponentAtBasisElem =
-            [this,&received](BasisElem const & be) -> typename SyndromeType::value_type {
-                auto tit = boost::make_transform_iterator(this->curvePoints.begin(),
-                        std::bind(
-                            computeMonomAtPoint<Field, BasisElem, CurvePoint>,
-                            be,
-                            _1));
-                return typename SyndromeType::value_type(
-                        be,
-                        std::inner_product(received.begin(), received.end(),
-                            tit, FieldElemTraits<Field>::addId()));
-
-        };
-        std::transform(basis.begin(), basis.end(),
-                std::inserter(syn, syn.begin()), syndromComponentAtBasisElem);
-        // END OF computing "known" syndroms
+    /**
+     * Discrepancies of the polynomials of \c F (pairs of a degree and a
+     * polynomial) at \c points (all of the same weight) for the syndrome
+     * at the first point being 0 and 1 (cf. elect).
+     * @param degs Degrees of \c F, filled.
+     */
+    template<typename PointPolyRange>
+    static void computeDiscrepancies(
+            SyndromeType & syn,
+            PointPolyRange const & F,
+            std::vector<LatticePointT> const & points,
+            std::vector<LatticePointT> & degs,
+            std::vector<Field> & d0,
+            std::vector<Field> & d1) {
+        Field const zero = FieldElemTraits<Field>::addId();
+        Field const one = FieldElemTraits<Field>::multId();
+        degs.clear();
+        // the support of every f is collected once for all of the points
+        std::vector< SupportTerms<LatticePointT, Field> > supports;
+        for (auto it = F.begin(); it != F.end(); ++it) {
+            degs.push_back(it->first);
+            supports.push_back(SupportTerms<LatticePointT, Field>(it->second, it->first));
+        }
+        Field const * xs[] = { &zero, &one };
+        std::vector<Field> * ds[] = { &d0, &d1 };
+        for (int v = 0; v < 2; ++v) {
+            ds[v]->clear();
+            fillSyndromes(syn, points, *xs[v]);
+            for (size_t j = 0; j < points.size(); ++j)
+                for (size_t f = 0; f < degs.size(); ++f)
+                    ds[v]->push_back(byCoordinateLess(degs[f], points[j])
+                            ? convSupport(supports[f], syn, degs[f], points[j])
+                            : zero);
+        }
+    }
 
+    /**
+     * Extends the syndromes up to \c weight by the recurrences of \c F, i.e.
+     * as elect does without voters. Once F is the Groebner basis of the
+     * error locator ideal, the extended syndromes are the ones of the error.
+     */
+    template<typename PointPolyRange>
+    static void extendSyndromes(
+            SyndromeType & syn,
+            PointPolyRange const & F,
+            long weight) {
+        std::vector<LatticePointT> degs;
+        std::vector<Field> d0, d1;
+        while (ECCodeParams::weight(syn.getEnd()) <= weight) {
+            std::vector<LatticePointT> const points = getPointsOfWeight(syn.getEnd());
+            computeDiscrepancies(syn, F, points, degs, d0, d1);
+            fillSyndromes(syn, points, elect(degs, points, d0, d1,
+                    std::vector<unsigned>(d0.size(), 0)));
+        }
+    }
+
+    /**
+     * Feng-Rao majority voting for the unknown syndromes of the weight of
+     * bmsa.nextPoint(), after which the algorithm steps over the points of
+     * that weight. A basis element q with q and k - q outside of the
+     * delta-set, k - q being a basis element as well, votes for the
+     * candidate of the first f in F below q: there are as many such pairs
+     * as the Feng-Rao bound counts, so if the number of errors is within
+     * half of it, the correct candidate gets the majority of the votes.
+     * (The pairs with non-basis monomials are left out: their wrong votes
+     * aren't bounded by the growth of the delta-set.) Every vote costs
+     * O(|F|) convolutions.
+     */
+    static void frmv(BmsaT & bmsa, SyndromeType & syn, DeltaSetGrid<LatticePointT> & delta) {
+        std::vector<LatticePointT> const points = getPointsOfWeight(bmsa.nextPoint());
+        std::vector<LatticePointT> degs;
+        std::vector<Field> d0, d1;
+        computeDiscrepancies(syn, bmsa.getF(), points, degs, d0, d1);
+        fillSyndromes(syn, points,
+                elect(degs, points, d0, d1, countVotes(delta, degs, points)));
+        for (size_t j = 0; j < points.size(); ++j) {
+            bmsa.step(syn[points[j]]);
+            delta.update(bmsa.getDeltaPoints());
+        }
+    }
+
+    /**
+     * frmv for all the words of a batch: the sub-batches share the
+     * delta-set and F up to coefficients, so the voters are counted once
+     * per sub-batch and only the discrepancies are computed per word.
+     * @param syns Syndromes of the words.
+     * @param deltas Delta-sets of the words.
+     */
+    static void frmvBatch(
+            BatchedBmsaT & bmsa,
+            std::vector<SyndromeType> & syns,
+            std::vector< DeltaSetGrid<LatticePointT> > & deltas) {
+        Field const zero = FieldElemTraits<Field>::addId();
+        Field const one = FieldElemTraits<Field>::multId();
+        std::vector<LatticePointT> const points = getPointsOfWeight(bmsa.nextPoint());
+        size_t const width = syns.size();
+        std::vector<Field> values(width);
+
+        // discrepancies at x = 0 and at x = 1 per sub-batch, point and lane
+        std::vector< std::vector<Field> > ds[2];
+        Field const * xs[] = { &zero, &one };
+        for (int v = 0; v < 2; ++v) {
+            for (size_t w = 0; w < width; ++w)
+                fillSyndromes(syns[w], points, *xs[v]);
+            for (size_t j = 0; j < points.size(); ++j) {
+                for (size_t w = 0; w < width; ++w)
+                    values[w] = syns[w][points[j]];
+                bmsa.setSequenceElements(points[j], values);
+            }
+            for (size_t b = 0; b < bmsa.getSubBatchCnt(); ++b)
+                for (size_t j = 0; j < points.size(); ++j)
+                    ds[v].push_back(bmsa.getDiscrepancies(b, points[j]));
+        }
+
+        std::vector<Field> elected(width, zero);
+        for (size_t b = 0; b < bmsa.getSubBatchCnt(); ++b) {
+            std::vector<size_t> const & lanes = bmsa.getLanes(b);
+            std::vector<LatticePointT> const degs = bmsa.getDegrees(b);
+            std::vector<unsigned> const votes =
+                    countVotes(deltas[lanes[0]], degs, points);
+            std::vector<Field> d0(points.size() * degs.size());
+            std::vector<Field> d1(d0.size());
+            for (size_t l = 0; l < lanes.size(); ++l) {
+                for (size_t j = 0; j < points.size(); ++j)
+                    for (size_t i = 0; i < degs.size(); ++i) {
+                        d0[j * degs.size() + i] =
+                                ds[0][b * points.size() + j][i * lanes.size() + l];
+                        d1[j * degs.size() + i] =
+                                ds[1][b * points.size() + j][i * lanes.size() + l];
+                    }
+                elected[lanes[l]] = elect(degs, points, d0, d1, votes);
+            }
+        }
+
+        for (size_t w = 0; w < width; ++w)
+            fillSyndromes(syns[w], points, elected[w]);
+        for (size_t j = 0; j < points.size(); ++j) {
+            for (size_t w = 0; w < width; ++w)
+                values[w] = syns[w][points[j]];
+            bmsa.step(values);
+            for (size_t b = 0; b < bmsa.getSubBatchCnt(); ++b) {
+                std::vector<size_t> const & lanes = bmsa.getLanes(b);
+                for (size_t l = 0; l < lanes.size(); ++l)
+                    deltas[lanes[l]].update(bmsa.getDeltaPoints(b));
+            }
+        }
+    }
+
+    // computing "known" syndroms: at all the points of the plane up to the
+    // weight of the last basis element, the product of the parity-check
+    // matrix by the word
+    SyndromeType
+    computeSyndromes(FieldElemsCollection const & received) const {
+        SyndromeType syn;
+        std::vector<LatticePointT> const & points = context.getSyndromePoints();
+        std::vector<Field> const & h = context.getParityCheckMatrix();
+        size_t const n = context.getCurvePoints().size();
+        for (size_t i = 0; i < points.size(); ++i)
+            syn.set(points[i],
+                    std::inner_product(received.begin(), received.end(),
+                        h.begin() + i * n, FieldElemTraits<Field>::addId()));
+        return syn;
+    }
+
+    /**
+     * Runs \c bmsa for the known syndromes \c syn and continues it with
+     * the unknown ones found by majority voting up to the locator weight.
+     * @return Error locators: the polynomials the algorithm ends with.
+     */
+    PolynomialCollection findErrorLocators(BmsaT & bmsa, SyndromeType & syn) const {
         // **********  logging
-        log_oss.str("");
-        std::for_each(syn.begin(), syn.end(),
-                [&log_oss](typename SyndromeType::value_type const & s) {
-                    log_oss << makeNtlPowerPrinter(s.second) << " ";
-                }
-        );
-        LOG(INFO) << "Known syndroms: " << log_oss.str();
+        MV_POLY_LOG(MV_POLY_TRACE_STEPS) << "Known syndroms: " << mapToStr(syn);
         // **********  ENF OF logging
 
         // compute error locators for the known syndroms
-        BmsaT bmsa(syn, ++basis.back());
-        auto minset = bmsa.computeMinimalSet();
+        bmsa.setSupportCaching(true);
+        bmsa.setTraceSink(traceSink);
+        bmsa.computeMinimalSet();
+
+        // and continue with the unknown ones found by majority voting
+        DeltaSetGrid<LatticePointT> delta;
+        delta.update(bmsa.getDeltaPoints());
+        while (ECCodeParams::weight(bmsa.nextPoint()) <= context.getLocatorWeight())
+            frmv(bmsa, syn, delta);
+        PolynomialCollection minset = bmsa.current();
 
         // **********  logging
-        for_each(minset.begin(), minset.end(),
-                [](typename BmsaT::PolynomialCollection::value_type const & p) {
-                    LOG(INFO) << "Error locator: " <<
-                            makePowerPrinter< OrderPolicyHolder::template impl >(p)
-                            << std::endl;
-                }
-        );
+        if (MV_POLY_TRACE_ENABLED(MV_POLY_TRACE_STEPS))
+            for_each(minset.begin(), minset.end(),
+                    [](typename BmsaT::PolynomialCollection::value_type const & p) {
+                        LOG(INFO) << "Error locator: " <<
+                                makePowerPrinter< LatticeOrderPolicyHolder::template impl >(p)
+                                << std::endl;
+                    }
+            );
         // **********  ENF OF logging
 
-//        while(true) { // TODO: define stop condition
-//            frmv(bmsa);
-//            ++bmsa;   // TODO: ++ should be correctly implemented for given OrderPolicy
-//        }
         return minset;
     }
 
 public:
 
-    BMSDecoding(
-            size_t l)
-    : l(l) {
-        curvePoints = ECCodeParams::getRationalPoints();
-        
-        // Logging
-        LOG(INFO) << "Curve points";
-        for (auto cpt : curvePoints) {
-            LOG(INFO) << "("
-                      << makeNtlPowerPrinter(cpt[0])  << ", "
-                      << makeNtlPowerPrinter(cpt[1])   << ")";
+    /**
+     * Decoder of the code with \c l checks with a context of its own. The
+     * decoders of the same code should rather share one (cf.
+     * BMSDecoding(Context const &)).
+     */
+    explicit BMSDecoding(size_t l)
+    : ownedContext(std::make_shared<Context const>(l)),
+      context(*ownedContext) {}
+
+    /**
+     * Decoder sharing \c context_, which has to outlive it. Nothing is
+     * computed, and \c decode doesn't change the decoder, so a decoder can
+     * be used by several threads at once.
+     */
+    explicit BMSDecoding(Context const & context_)
+    : context(context_) {}
+
+    Context const & getContext() const {
+        return context;
+    }
+
+    /// Number of errors the decoder corrects: half the Feng-Rao distance.
+    int getCorrectable() const {
+        return context.getCorrectable();
+    }
+
+#if MV_POLY_PERF_COUNTERS
+    /**
+     * Writes the counters as JSON: the number of decoded words, the time of
+     * the phases of decoding (syndromes, BMS-algorithm, error locations,
+     * error values) and the counters of BMS-algorithm (cf.
+     * BmsaCounters::writeJson), all of them summed over the words. Decodes
+     * running meanwhile may be counted in part.
+     */
+    void writeCountersJson(std::ostream & os) const {
+        DecodingCounters run;
+        run += counters;
+        os << "{\"words\": " << run.words
+           << ", \"syndromeTime\": " << run.syndromeTime
+           << ", \"bmsaTime\": " << run.bmsaTime
+           << ", \"locationTime\": " << run.locationTime
+           << ", \"valueTime\": " << run.valueTime
+           << ", \"bmsa\": {\"total\": ";
+        BmsaCounters(bmsaCounters).writeJson(os);
+        os << "}}";
+    }
+
+    void resetCounters() {
+        counters.clear();
+        bmsaCounters.clear();
+    }
+#endif
+
+    /**
+     * Sets the sink for the steps of BMS-algorithm run by \c decode (cf.
+     * BMSAlgorithm::setTraceSink).
+     */
+    void setTraceSink(typename BmsaT::TraceSink const & sink) {
+        traceSink = sink;
+    }
+
+    /**
+     * Known syndromes of every word of \c words, the same as for one word:
+     * the words are the columns of a matrix multiplied by the parity-check
+     * matrix of the context with multiplyBlocked, so the monomials at the
+     * points are taken from the context once for the whole batch.
+     */
+    std::vector<SyndromeType>
+    computeSyndromesBatch(std::vector<FieldElemsCollection> const & words) const {
+        std::vector<LatticePointT> const & points = context.getSyndromePoints();
+        size_t const n = context.getCurvePoints().size();
+        size_t const width = words.size();
+        std::vector<Field> stacked(n * width);
+        for (size_t w = 0; w < width; ++w)
+            for (size_t p = 0; p < n; ++p)
+                stacked[p * width + w] = words[w][p];
+        std::vector<Field> const product = multiplyBlocked(points.size(), n,
+                width, context.getParityCheckMatrix(), stacked);
+
+        std::vector<SyndromeType> result(width);
+        for (size_t i = 0; i < points.size(); ++i)
+            for (size_t w = 0; w < width; ++w)
+                result[w].set(points[i], product[i * width + w]);
+        return result;
+    }
+
+    /**
+     * A word between the stages of decoding: the stages fill the fields
+     * in turn (cf. runSyndromeStage, runLocatorStage, runRootStage,
+     * runValueStage), so a word can be passed from thread to thread.
+     */
+    struct DecodingJob {
+        FieldElemsCollection received;
+
+        SyndromeType syndromes;
+
+        /// F and G of BMS-algorithm (cf. BMSAlgorithm::getF, getG).
+        typename BmsaT::PointPolyMap F, G;
+
+        PolynomialCollection locators;
+
+        ErrorPositions locations;
+
+        FieldElemsCollection corrected;
+
+#if MV_POLY_PERF_COUNTERS
+        /// Counters of BMS-algorithm summed over its steps.
+        BmsaCounters bmsaCounters;
+#endif
+    };
+
+    /// Known syndromes of the received word.
+    void runSyndromeStage(DecodingJob & job) const {
+        job.syndromes = computeSyndromes(job.received);
+    }
+
+    /// Error locators by BMS-algorithm with majority voting.
+    void runLocatorStage(DecodingJob & job) const {
+        BmsaT bmsa(job.syndromes, job.syndromes.getEnd());
+        job.locators = findErrorLocators(bmsa, job.syndromes);
+        MV_POLY_COUNT(job.bmsaCounters = bmsa.getPerfCounters().getTotal());
+        bmsa.releaseFG(job.F, job.G);
+    }
+
+    /// Error positions: the common roots of the locators.
+    void runRootStage(DecodingJob & job) const {
+        job.locations = getErrorLocations(job.locators);
+    }
+
+    /// Error values and the corrected word.
+    void runValueStage(DecodingJob & job) const {
+        job.corrected = correctErrors(job.received, job.syndromes,
+                job.F, job.G, job.locations);
+    }
+
+    /// Error positions in \c r (without correcting it, cf. decode).
+    ErrorPositions locateErrors(FieldElemsCollection const & r) const {
+        DecodingJob job;
+        job.received = r;
+        runStages(job, false);
+        return job.locations;
+    }
+
+    /**
+     * Corrects the errors in \c r: the positions are found by
+     * BMS-algorithm with majority voting, the values by getErrorValues from
+     * the polynomials the algorithm ends with. An uncorrectable word is
+     * returned as is.
+     */
+    FieldElemsCollection decode(FieldElemsCollection const & r) const {
+        DecodingJob job;
+        job.received = r;
+        runStages(job, true);
+        return job.corrected;
+    }
+
+    /**
+     * Corrected words for every word of \c words, the same as \c decode
+     * gives for it: BMS-algorithm is run for all the words together (cf.
+     * BatchedBMSAlgorithm), so the words with the same error locator
+     * staircase share its control flow and the voters of majority voting.
+     */
+    std::vector<FieldElemsCollection>
+    decodeBatch(std::vector<FieldElemsCollection> const & words) const {
+        std::vector<FieldElemsCollection> result;
+        if (words.empty())
+            return result;
+        MV_POLY_COUNT(DecodingCounters run);
+        MV_POLY_COUNT(run.words = words.size());
+        MV_POLY_COUNT(PhaseTimer syndromeTimer(run.syndromeTime));
+        std::vector<SyndromeType> syndromes = computeSyndromesBatch(words);
+        MV_POLY_COUNT(syndromeTimer.stop());
+
+        MV_POLY_COUNT(PhaseTimer bmsaTimer(run.bmsaTime));
+        BatchedBmsaT bmsa(syndromes, syndromes[0].getEnd());
+        bmsa.computeMinimalSets();
+        std::vector< DeltaSetGrid<LatticePointT> > deltas(words.size());
+        for (size_t b = 0; b < bmsa.getSubBatchCnt(); ++b) {
+            std::vector<size_t> const & lanes = bmsa.getLanes(b);
+            for (size_t l = 0; l < lanes.size(); ++l)
+                deltas[lanes[l]].update(bmsa.getDeltaPoints(b));
         }
+        while (ECCodeParams::weight(bmsa.nextPoint()) <= context.getLocatorWeight())
+            frmvBatch(bmsa, syndromes, deltas);
+        std::vector<PolynomialCollection> const minsets = bmsa.current();
+        MV_POLY_COUNT(bmsaTimer.stop());
+        MV_POLY_LOG(MV_POLY_TRACE_SUMMARY) << "Decoded " << words.size() << " words in "
+                << bmsa.getSubBatchCnt() << " sub-batches";
+
+        MV_POLY_COUNT(PhaseTimer locationTimer(run.locationTime));
+        std::vector<ErrorPositions> locations;
+        locations.reserve(words.size());
+        for (size_t i = 0; i < minsets.size(); ++i)
+            locations.push_back(getErrorLocations(minsets[i]));
+        MV_POLY_COUNT(locationTimer.stop());
+
+        MV_POLY_COUNT(PhaseTimer valueTimer(run.valueTime));
+        std::vector<typename BatchedBmsaT::PointPolynomialCollection> const
+            fs = bmsa.currentF(), gs = bmsa.currentG();
+        result.reserve(words.size());
+        for (size_t i = 0; i < words.size(); ++i)
+            result.push_back(correctErrors(words[i], syndromes[i],
+                    fs[i], gs[i], locations[i]));
+        MV_POLY_COUNT(valueTimer.stop());
+        MV_POLY_COUNT(addCounters(run, 0));
+        return result;
     }
 
-    // Should return FieldElemsCollection but getErrorValues NIY
-    ErrorPositions decode(FieldElemsCollection const & r) {
-        FieldElemsCollection result;
-        ErrorPositions locations = 
-                                    getErrorLocations(
-                                        computeErrorLocatorPolynomials(r));
-        // FieldElemsCollection values = getErrorValues(locations);
-        // correct r with locators and values...
-        // return result;
-        return locations;
+private:
+    /**
+     * Runs the stages of decoding on \c job one after another (the value
+     * stage if \c values) and adds the word to the counters.
+     */
+    void runStages(DecodingJob & job, bool values) const {
+        MV_POLY_COUNT(DecodingCounters run);
+        MV_POLY_COUNT(run.words = 1);
+        MV_POLY_COUNT(PhaseTimer syndromeTimer(run.syndromeTime));
+        runSyndromeStage(job);
+        MV_POLY_COUNT(syndromeTimer.stop());
+
+        MV_POLY_COUNT(PhaseTimer bmsaTimer(run.bmsaTime));
+        runLocatorStage(job);
+        MV_POLY_COUNT(bmsaTimer.stop());
+
+        MV_POLY_COUNT(PhaseTimer locationTimer(run.locationTime));
+        runRootStage(job);
+        MV_POLY_COUNT(locationTimer.stop());
+
+        if (values) {
+            MV_POLY_COUNT(PhaseTimer valueTimer(run.valueTime));
+            runValueStage(job);
+        }
+        MV_POLY_COUNT(addCounters(run, &job.bmsaCounters));
     }
 }; // BMSDecoding
 
@@ -10,12 +10,17 @@
 #ifndef BMSA_HPP_
 #define BMSA_HPP_
 
+#include <algorithm>
+#include <functional>
 #include <iostream>
 #include <iomanip>
+#include <sstream>
+#include <stdexcept>
 #include <iterator>
 #include <list>
 #include <map>
 #include <utility>
+#include <vector>
 
 #include <boost/iterator/transform_iterator.hpp>
 #include <boost/range/iterator_range.hpp>
@@ -28,6 +33,13 @@
 #include "Utilities.hpp"
 #include "Point.hpp"
 #include "CoefficientTraits.hpp"
+#include "SequenceView.hpp"
+#include "DenseSequence.hpp"
+#include "Executor.hpp"
+#include "FlatMap.hpp"
+#include "Serialization.hpp"
+#include "Trace.hpp"
+#include "PerfCounters.hpp"
 
 namespace mv_poly {
 
@@ -42,17 +54,49 @@ public:
 
     typedef Point<Dim, OrderPolicy> PointT;
 
-    typedef std::map< PointT, PolynomialT > PointPolyMap;
+    /**
+     * Polynomials indexed by their degrees. It's a sorted vector (cf.
+     * FlatMap) with std::map-like interface: F and G are rebuilt at
+     * every step into the second buffer which is then swapped in.
+     */
+    typedef FlatMap< PointT, PolynomialT > PointPolyMap;
 
     typedef std::list< PolynomialT > PolynomialCollection;
 
-    typedef std::list< PointT > PointCollection;
+    typedef std::vector< PointT > PointCollection;
+
+    /**
+     * Structured record of one step of the algorithm passed to the trace
+     * sink (cf. setTraceSink).
+     */
+    struct StepTrace {
+        /// The point the step was made for.
+        PointT k;
+
+        /// Polynomials of F the discrepancy was computed for.
+        size_t spanningCnt;
+
+        /// Nonzero discrepancies among them.
+        size_t nonzeroCnt;
+
+        /// Polynomials of new F obtained by Berlekamp formula (the others
+        /// are obtained by deg bump).
+        size_t berlekampCnt;
+
+        /// Delta-set after the step (maximal points).
+        PointCollection deltaPoints;
+
+        /// Degrees of polynomials of new F.
+        PointCollection sigmaPoints;
+    };
+
+    typedef std::function<void (StepTrace const &)> TraceSink;
 
 private:
 
     typedef typename PolynomialT::CoefT CoefT;
 
-    typedef std::map< PointT, CoefT > PointCoefMap;
+    typedef FlatMap< PointT, CoefT > PointCoefMap;
 
     PointPolyMap G;
 
@@ -60,12 +104,247 @@ private:
 
     PointT seqLen;
 
+    PointT curPoint; // the next step is infoUpdate(curPoint)
+
     PointCollection oldDeltaPoints;
 
     PointPolyMap F;
 
     SeqT & seq;
 
+    /// Support of f (cf. SupportTerms) cached between the steps.
+    struct CachedSupport {
+        SupportTerms<PointT, CoefT> terms;
+
+        /// Extracted from f and not used for convolution yet.
+        bool fresh;
+    };
+
+    typedef FlatMap< PointT, CachedSupport > PointSupportMap;
+
+    bool cachingSupports;
+
+    PointSupportMap supports; // keys are the same as of F
+
+    SequenceViewHolder<SeqT, Dim, CoefT> seqView;
+
+#if MV_POLY_PERF_COUNTERS
+    BmsaPerfCounters<PointT> perf;
+#endif
+
+    WorkStealingPool * executor;
+
+    // buffers for the next F, G and supports, swapped with the current ones
+    // at the end of every step
+
+    PointPolyMap nextF;
+
+    PointPolyMap nextG;
+
+    PointSupportMap nextSupports;
+
+    std::vector<PointT> nextFKeys;
+
+    std::vector<PointT> nextSupportKeys;
+
+    PointCoefMap discr; // discrepancies at the current step
+
+    TraceSink traceSink;
+
+    static CachedSupport makeSupport(PolynomialT const & f, PointT const & degF) {
+        CachedSupport result = { SupportTerms<PointT, CoefT>(f, degF), true };
+        return result;
+    }
+
+    /// Support of f in \c cached, whose storage is reused.
+    static void assignSupport(CachedSupport & cached, PolynomialT const & f, PointT const & degF) {
+        cached.terms.assign(f, degF);
+        cached.fresh = true;
+    }
+
+    /// Calls <tt>body(i)</tt> for i in [0, n): on executor if it is set.
+    template<typename Body>
+    void forEachIndex(size_t n, Body const & body) {
+        if (executor) {
+            executor->parallelFor(n, body);
+        } else {
+            for (size_t i = 0; i < n; ++i)
+                body(i);
+        }
+    }
+
+    /// Counts the use of the cached support of f.
+    void useSupport(CachedSupport & cached) {
+        if (cached.fresh) {
+            cached.fresh = false;
+            MV_POLY_COUNT(++perf.current().newSupportUses);
+        } else {
+            MV_POLY_COUNT(++perf.current().reusedSupportUses);
+        }
+    }
+
+#if MV_POLY_PERF_COUNTERS
+    /// Nonzero terms of f which \c conv sums up (cf. SupportTerms).
+    unsigned long countConvolutionTerms(PolynomialT const & f, PointT const & degF) const {
+        unsigned long result = 0;
+        CoefT const & zero = ZERO;
+        forEachCoefficient<PointT>(f,
+                [&result, &zero, &degF](PointT const & pt, CoefT const & c) {
+                    if (c != zero && pt.isCanonical() && pt <= degF)
+                        ++result;
+                });
+        return result;
+    }
+
+    /// Stored coefficients of f (all of them are multiplied by a scalar).
+    static unsigned long countCoefficients(PolynomialT const & f) {
+        unsigned long result = 0;
+        forEachCoefficient<PointT>(f,
+                [&result](PointT const &, CoefT const &) { ++result; });
+        return result;
+    }
+#endif
+
+    typedef typename PointPolyMap::iterator PointPolyIterator;
+
+    /**
+     * Discrepancies at k of f in \c spanning: \c conv(f, seq, degF, k) or,
+     * with support caching, the same sum over the cached support of f. With
+     * executor set all of them are computed in parallel reading the sequence
+     * through the dense view (as \c conv may insert into a map).
+     */
+    void computeDiscrepancies(
+            std::vector<PointPolyIterator> const & spanning,
+            PointT const & k,
+            std::vector<CoefT> & values) {
+        MV_POLY_COUNT(PhaseTimer timer(perf.current().discrepancyTime));
+        MV_POLY_COUNT(perf.current().convolutions += spanning.size());
+        MV_POLY_COUNT(unsigned long const termsBefore = perf.current().convolutionTerms);
+        values.assign(spanning.size(), ZERO);
+        if (cachingSupports) {
+            for (size_t i = 0; i < spanning.size(); ++i)
+                if (!supports.count(spanning[i]->first))
+                    supports.insert(std::make_pair(spanning[i]->first,
+                            makeSupport(spanning[i]->second, spanning[i]->first)));
+            // supports is not changed below, so the pointers stay valid
+            std::vector<CachedSupport const *> & used = spanningSupports;
+            used.clear();
+            for (size_t i = 0; i < spanning.size(); ++i) {
+                CachedSupport & cached = supports.find(spanning[i]->first)->second;
+                useSupport(cached);
+                used.push_back(&cached);
+                MV_POLY_COUNT(perf.current().convolutionTerms += cached.terms.size());
+            }
+            forEachIndex(spanning.size(),
+                    [this, &spanning, &used, &k, &values](size_t i) {
+                        values[i] = convSupport(used[i]->terms,
+                                this->seqView.get(this->seq),
+                                spanning[i]->first, k);
+                    });
+        } else if (executor) {
+            std::vector< SupportTerms<PointT, CoefT> > & terms = spanningTerms;
+            if (terms.size() < spanning.size())
+                terms.resize(spanning.size());
+            forEachIndex(spanning.size(),
+                    [this, &spanning, &terms, &k, &values](size_t i) {
+                        terms[i].assign(spanning[i]->second, spanning[i]->first);
+                        values[i] = convSupport(terms[i],
+                                this->seqView.get(this->seq),
+                                spanning[i]->first, k);
+                    });
+            MV_POLY_COUNT(
+                for (size_t i = 0; i < spanning.size(); ++i)
+                    perf.current().convolutionTerms += terms[i].size();
+            )
+        } else {
+            for (size_t i = 0; i < spanning.size(); ++i) {
+                values[i] = conv(spanning[i]->second, seq, spanning[i]->first, k);
+                MV_POLY_COUNT(perf.current().convolutionTerms += countConvolutionTerms(
+                        spanning[i]->second, spanning[i]->first));
+            }
+        }
+        MV_POLY_COUNT(perf.current().fieldMults +=
+                perf.current().convolutionTerms - termsBefore);
+    }
+
+    /**
+     * How to get f of new F with degree t from F and G: either F[s] << u
+     * (deg bump) or by Berlekamp formula with G[c]; F[s] is taken (not
+     * copied) if \c takeF, i.e. nothing else uses it.
+     */
+    struct NewFPlan {
+        PointT t;
+
+        PointT s;
+
+        PointT u;
+
+        bool berlekamp;
+
+        PointT c;
+
+        bool takeF;
+
+        bool operator<(NewFPlan const & other) const {
+            return t < other.t;
+        }
+    };
+
+    // buffers of a step: cleared and refilled at every step, so they
+    // allocate only when they grow
+
+    std::vector<PointPolyIterator> spanning; // f in F with deg f <= k
+
+    std::vector<CoefT> spanningDiscr; // discrepancies of spanning
+
+    std::vector<CachedSupport const *> spanningSupports;
+
+    std::vector< SupportTerms<PointT, CoefT> > spanningTerms; // with executor only
+
+    std::vector<NewFPlan> plans;
+
+    std::vector<CachedSupport *> supportSlots;
+
+    PointCollection deltaPoints;
+
+    PointCollection sigmaPoints;
+
+    PointCollection pointBuffer;
+
+    /**
+     * Polynomial of new F (and its support with support caching if
+     * \c support isn't null) in the slot \c f, whose storage is reused.
+     */
+    void buildNewF(
+            NewFPlan const & plan,
+            PointT const & k,
+            PolynomialT & f,
+            CachedSupport * support) {
+        PolynomialT & fs = F.find(plan.s)->second;
+        if (plan.takeF)
+            f.swap(fs); // the old slot storage goes to F, to be reused next step
+        else
+            f = fs;
+        PolyKernels<Dim>::shift(f, plan.u);
+        if (plan.berlekamp) {
+            subtractShiftedMultiple(f, // Berlekamp formula
+                    discr.find(plan.s)->second, G.find(plan.c)->second,
+                    plan.c - (k - plan.t));
+            if (support)
+                assignSupport(*support, f, plan.t);
+        } else if (support) {
+            // support of x^u * f is the shifted support of f
+            CachedSupport & ss = supports.find(plan.s)->second;
+            if (plan.takeF) {
+                support->terms.swap(ss.terms);
+                support->fresh = ss.fresh;
+            } else {
+                *support = ss;
+            }
+            support->terms.shift(plan.u);
+        }
+    }
+
 public:
 
     void infoUpdate(PointT const & k) {
@@ -74,37 +353,46 @@ public:
         using namespace std::tr1::placeholders;
         using std::cout;
         using std::endl;
-        LOG(INFO) << "Enter InfoUpdate(k), k = " << k << endl;
+        MV_POLY_LOG(MV_POLY_TRACE_STEPS) << "Enter InfoUpdate(k), k = " << k << endl;
 
-        PointCollection deltaPoints, sigmaPoints;
-        PointCoefMap discr; // discrepancies
+        deltaPoints.clear();
+        discr.clear();
+        MV_POLY_COUNT(perf.beginStep(k));
+        MV_POLY_COUNT(BmsaCounters & stepCounters = perf.current());
+
+        spanning.clear();
+        for (PointPolyIterator fIt = F.begin(); fIt != F.end(); ++fIt)
+            if (byCoordinateLess(fIt->first, k))
+                spanning.push_back(fIt);
+        computeDiscrepancies(spanning, k, spanningDiscr);
 
         //searching for candidates to form new deltaPoints
-        LOG(INFO) << "traversing F (building new delta-set)" << endl;
-        for (typename PointPolyMap::iterator fIt = F.begin();
-                fIt != F.end(); ++fIt) {
-            Point<Dim, OrderPolicy> const & degF = fIt->first;
-            PolynomialT & f = fIt->second;
-            if (byCoordinateLess(degF, k)) {
-                CoefT b = conv(f, seq, degF, k);
-                discr[degF] = b;
+        MV_POLY_LOG(MV_POLY_TRACE_STEPS) << "traversing F (building new delta-set)" << endl;
+        for (size_t i = 0; i < spanning.size(); ++i) {
+            Point<Dim, OrderPolicy> const & degF = spanning[i]->first;
+            PolynomialT & f = spanning[i]->second;
+            {
+                CoefT b = spanningDiscr[i];
+                discr.push_back(degF, CoefT(b)); // F is sorted by degree
+                MV_POLY_COUNT(stepCounters.nonzeroDiscrepancies += (b != ZERO));
                 Point<Dim, OrderPolicy> c = k - degF;
-                LOG_IF(INFO, b != ZERO) << "\t d != 0, fallen:" << f;
-                LOG_IF(INFO, b != ZERO) << "\t\tspan (c): " << c << endl;
+                MV_POLY_LOG_IF(MV_POLY_TRACE_STEPS, b != ZERO) << "\t d != 0, fallen:" << f;
+                MV_POLY_LOG_IF(MV_POLY_TRACE_STEPS, b != ZERO) << "\t\tspan (c): " << c << endl;
                 if  (b != ZERO &&
                         !byCoordinateLessThenAny(
                                 c,
                                 make_choose_point_iterator(G.begin()),
                                 make_choose_point_iterator(G.end()))) {
                     deltaPoints.push_back(c);
-                    LOG(INFO) << "\t\tc is a new delta-point";
+                    MV_POLY_LOG(MV_POLY_TRACE_STEPS) << "\t\tc is a new delta-point";
                 }
             }
         }
         
-        deltaPoints.splice(deltaPoints.end(), oldDeltaPoints); // push_back all olds
-        deltaPoints = getPartialMaximums(deltaPoints);
-        sigmaPoints = getConjugatePointCollection(deltaPoints);
+        deltaPoints.insert(deltaPoints.end(), oldDeltaPoints.begin(), oldDeltaPoints.end());
+        getPartialMaximums(deltaPoints, pointBuffer);
+        deltaPoints.swap(pointBuffer);
+        getConjugatePointCollection(deltaPoints, sigmaPoints, pointBuffer);
 
 //            cout << "Delta-points:" << endl;
 //            copy(deltaPoints.begin(), deltaPoints.end(),
@@ -113,40 +401,21 @@ public:
 //            copy(sigmaPoints.begin(), sigmaPoints.end(),
 //                    std::ostream_iterator< Point<Dim> >(cout, "\n"));
 
-        PointPolyMap newG;
-        // forming new G
-        LOG(INFO) << "forming new G (traversing new delta-set)" << endl;
-        for (typename PointCollection::const_iterator
-                cIt = deltaPoints.begin();
-                cIt != deltaPoints.end(); ++cIt) {
-            LOG(INFO) << "\tdelta-point: "  << *cIt << endl;
-            typename PointPolyMap::const_iterator tmpIt = G.find(*cIt);
-            if  (tmpIt != G.end()) {
-                LOG(INFO) << "\t\told G can handle it: "  << *tmpIt << endl;
-                newG.insert(*tmpIt);
-            }   else {
-                Point<Dim, OrderPolicy> s = k - *cIt;
-                newG[*cIt] =
-                        CoefficientTraits<CoefT>::multInverse(discr[s])
-                        * F[s];
-                LOG(INFO) << "\t\told f goes to new G: "  << newG[*cIt] << endl;
-            }
-        }
-
-        PointPolyMap newF;
+        MV_POLY_COUNT(PhaseTimer newFTimer(stepCounters.newFTime));
+        plans.clear();
         // forming new F
-        LOG(INFO) << "forming new F (traversing new sigma-points)" << endl;
+        MV_POLY_LOG(MV_POLY_TRACE_STEPS) << "forming new F (traversing new sigma-points)" << endl;
         for (typename PointCollection::const_iterator
                 tIt = sigmaPoints.begin();
                 tIt != sigmaPoints.end(); ++tIt) {
             Point<Dim, OrderPolicy> const & t = *tIt;
-            LOG(INFO) << "\tt: " << t << " ";
+            MV_POLY_LOG(MV_POLY_TRACE_STEPS) << "\tt: " << t << " ";
             
             // next find_if will find something for shure — I GUARANTEE IT
             auto fIt = std::find_if(
                     make_choose_point_iterator(F.begin()),
                     make_choose_point_iterator(F.end()),
-                    bind(&byCoordinateLess<Dim, OrderPolicy>, _1, cref(t)));
+                    std::tr1::bind(&byCoordinateLess<Dim, OrderPolicy>, _1, cref(t)));
             CHECK(fIt != make_choose_point_iterator(F.end()))
                 << "CRITICAL: supporting f absent for given t: " << t;
                 
@@ -156,7 +425,7 @@ public:
                 << "CRITICAL: supporting f is not such that byCoordinateLess(deg(f), t), f: " 
                 << *(fIt);
 
-            LOG(INFO)
+            MV_POLY_LOG(MV_POLY_TRACE_STEPS)
                 << "\ts: " << s << " "
                 << "u: " << u
                 << endl;
@@ -167,62 +436,358 @@ public:
                 const typename PointPolyMap::const_iterator cIt = (std::find_if(
                         make_choose_point_iterator(G.begin()),
                         make_choose_point_iterator(G.end()),
-                        bind(&byCoordinateLess<Dim, OrderPolicy>, cref(k - t), _1))
+                        std::tr1::bind(&byCoordinateLess<Dim, OrderPolicy>, cref(k - t), _1))
                         ).base();
                 if ((notJustIncreaseDegree = (cIt != G.end()))) {
                     // yes, I mean assignment at the top of if condition
-                    Point<Dim, OrderPolicy> const & c = cIt->first;
-                    newF[t] = (F[s] << u) - // Berlekamp formula
-                        (discr[s] * G[c] << (c - (k - t)));
-                    LOG(INFO) << "\tnew f via Berlekamp formula (deg is const)";
+                    NewFPlan plan = { t, s, u, true, cIt->first, false };
+                    plans.push_back(plan);
+                    MV_POLY_COUNT(++stepCounters.berlekampUpdates);
+                    MV_POLY_COUNT(stepCounters.fieldMults += countCoefficients(cIt->second));
+                    MV_POLY_LOG(MV_POLY_TRACE_STEPS) << "\tnew f via Berlekamp formula (deg is const)";
                 }
             }
             if (!notJustIncreaseDegree) {
-                newF[t] = F[s] << u;
-                LOG(INFO) << "\tnew f via deg bump";
+                NewFPlan plan = { t, s, u, false, PointT(), false };
+                plans.push_back(plan);
+                MV_POLY_COUNT(++stepCounters.degBumps);
+                MV_POLY_LOG(MV_POLY_TRACE_STEPS) << "\tnew f via deg bump";
+            }
+        }
+        // F[s] is taken by its plan if no other plan and no new g needs it
+        std::sort(plans.begin(), plans.end());
+        for (size_t i = 0; i < plans.size(); ++i) {
+            plans[i].takeF = true;
+            for (size_t j = 0; j < plans.size() && plans[i].takeF; ++j)
+                plans[i].takeF = j == i || !(plans[j].s == plans[i].s);
+            for (typename PointCollection::const_iterator cIt = deltaPoints.begin();
+                    cIt != deltaPoints.end() && plans[i].takeF; ++cIt)
+                plans[i].takeF = G.count(*cIt) || !(k - *cIt == plans[i].s);
+        }
+        // slots of new F are set up first, keeping the polynomials of the
+        // F before the last one for their storage, then filled (maybe in
+        // parallel as polynomials of new F are independent of each other)
+        nextFKeys.clear();
+        for (size_t i = 0; i < plans.size(); ++i)
+            nextFKeys.push_back(plans[i].t);
+        MV_POLY_COUNT(size_t const oldSlots = nextF.size());
+        nextF.assignKeys(nextFKeys.begin(), nextFKeys.end());
+        MV_POLY_COUNT(stepCounters.allocations +=
+                std::max(nextF.size(), oldSlots) - oldSlots);
+        // supports of new F are set up the same way in the slots of the
+        // supports before the last ones
+        nextSupportKeys.clear();
+        for (size_t i = 0; i < plans.size(); ++i) {
+            if (cachingSupports && (plans[i].berlekamp || supports.count(plans[i].s))) {
+                nextSupportKeys.push_back(plans[i].t);
+                MV_POLY_COUNT(
+                    if (plans[i].berlekamp)
+                        ++stepCounters.rebuiltSupports;
+                    else
+                        ++stepCounters.shiftedSupports;
+                )
+            }
+        }
+        MV_POLY_COUNT(size_t const oldSupportSlots = nextSupports.size());
+        nextSupports.assignKeys(nextSupportKeys.begin(), nextSupportKeys.end());
+        MV_POLY_COUNT(stepCounters.allocations +=
+                std::max(nextSupports.size(), oldSupportSlots) - oldSupportSlots);
+        supportSlots.clear();
+        for (size_t i = 0; i < plans.size(); ++i) {
+            typename PointSupportMap::iterator sIt = nextSupports.find(plans[i].t);
+            supportSlots.push_back(sIt != nextSupports.end() ? &sIt->second : 0);
+        }
+        typename PointPolyMap::iterator const slots = nextF.begin();
+        forEachIndex(plans.size(),
+                [this, &k, &slots](size_t i) {
+                    this->buildNewF(this->plans[i], k, slots[i].second, this->supportSlots[i]);
+                });
+        MV_POLY_COUNT(newFTimer.stop());
+        // end of forming new F
+
+        // forming new G: polynomials are moved from G and F as they are
+        // not needed any more
+        MV_POLY_COUNT(PhaseTimer newGTimer(stepCounters.newGTime));
+        nextG.clear();
+        MV_POLY_LOG(MV_POLY_TRACE_STEPS) << "forming new G (traversing new delta-set)" << endl;
+        for (typename PointCollection::const_iterator
+                cIt = deltaPoints.begin();
+                cIt != deltaPoints.end(); ++cIt) {
+            MV_POLY_LOG(MV_POLY_TRACE_STEPS) << "\tdelta-point: "  << *cIt << endl;
+            typename PointPolyMap::iterator tmpIt = G.find(*cIt);
+            if  (tmpIt != G.end()) {
+                MV_POLY_LOG(MV_POLY_TRACE_STEPS) << "\t\told G can handle it: "  << *tmpIt << endl;
+                nextG.insert(std::move(*tmpIt));
+            }   else {
+                Point<Dim, OrderPolicy> s = k - *cIt;
+                PolynomialT & g = nextG[*cIt] = std::move(F.find(s)->second);
+                g *= CoefficientTraits<CoefT>::multInverse(discr.find(s)->second);
+                MV_POLY_COUNT(++stepCounters.fieldInversions);
+                MV_POLY_COUNT(stepCounters.fieldMults += countCoefficients(g));
+                MV_POLY_LOG(MV_POLY_TRACE_STEPS) << "\t\told f goes to new G: "  << g << endl;
             }
-        } // end of forming new F
-        F = newF;
-        G = newG;
-        oldDeltaPoints.clear();
-        oldDeltaPoints.splice(oldDeltaPoints.end(), deltaPoints);
-            // this splice means: move contents of deltaPoints to oldDeltaPoints
-
-        LOG(INFO) << "F: " << endl;
-        copy(F.begin(), F.end(),
-                std::ostream_iterator<typename PointPolyMap::value_type>(LOG(INFO), "\n\t"));
-        LOG(INFO) << "G: " << endl << "\t";
-        copy(G.begin(), G.end(),
-                std::ostream_iterator<typename PointPolyMap::value_type>(LOG(INFO), "\n"));
-        LOG(INFO) << endl;
+        }
+
+        MV_POLY_COUNT(newGTimer.stop());
+
+        F.swap(nextF);
+        G.swap(nextG);
+        supports.swap(nextSupports);
+        oldDeltaPoints.swap(deltaPoints); // deltaPoints keeps the storage for the next step
+        MV_POLY_COUNT(stepCounters.deltaSize = oldDeltaPoints.size());
+        MV_POLY_COUNT(stepCounters.sigmaSize = sigmaPoints.size());
+        MV_POLY_COUNT(perf.endStep());
+
+        if (traceSink) {
+            StepTrace trace;
+            trace.k = k;
+            trace.spanningCnt = spanning.size();
+            trace.nonzeroCnt = spanning.size() - std::count(spanningDiscr.begin(), spanningDiscr.end(), ZERO);
+            trace.berlekampCnt = 0;
+            for (size_t i = 0; i < plans.size(); ++i)
+                trace.berlekampCnt += plans[i].berlekamp;
+            trace.deltaPoints = oldDeltaPoints;
+            trace.sigmaPoints = sigmaPoints;
+            traceSink(trace);
+        }
+
+        if (MV_POLY_TRACE_ENABLED(MV_POLY_TRACE_STEPS)) {
+            LOG(INFO) << "F: " << endl;
+            copy(F.begin(), F.end(),
+                    std::ostream_iterator<typename PointPolyMap::value_type>(LOG(INFO), "\n\t"));
+            LOG(INFO) << "G: " << endl << "\t";
+            copy(G.begin(), G.end(),
+                    std::ostream_iterator<typename PointPolyMap::value_type>(LOG(INFO), "\n"));
+            LOG(INFO) << endl;
+        }
     }
 
     BMSAlgorithm(
             SeqT & seq_,
-            PointT const & seqLen_) :
+            PointT const & seqLen_,
+            WorkStealingPool * executor_ = 0) :
                 ZERO(CoefficientTraits<CoefT>::addId()),
-                seqLen(seqLen_), seq(seq_) {
-        F.insert(std::make_pair(PointT(), PolynomialT::getId()));
+                seqLen(seqLen_), seq(seq_), cachingSupports(false),
+                executor(executor_) {
+        F.insert(std::make_pair(PointT(), PolynomialT::identity()));
     }
 
     PolynomialCollection computeMinimalSet() {
-        LOG(INFO) << "bmsa<" << Dim << ">::computeMinimalSet";
+        MV_POLY_LOG(MV_POLY_TRACE_SUMMARY) << "bmsa<" << Dim << ">::computeMinimalSet";
         // can't print seq as we SeqT can be various things 
-         LOG(INFO) << mapToStr(seq);
+        MV_POLY_LOG(MV_POLY_TRACE_STEPS) << mapToStr(seq);
                 
-        oldDeltaPoints.clear();
         // scanning input sequense step-by-step, following monomial order
-        for (Point<Dim, OrderPolicy> k; k < seqLen; ++k) {
-            infoUpdate(k);
+        // (resuming from the point where the previous call or step stopped)
+        if (cachingSupports || executor)
+            seqView.refresh(seq);
+        for (; curPoint < seqLen; ++curPoint) {
+            infoUpdate(curPoint);
         }
+        MV_POLY_COUNT(
+            MV_POLY_LOG(MV_POLY_TRACE_SUMMARY)
+                << perf.getTotal().convolutions << " convolutions ("
+                << perf.getTotal().convolutionTerms << " terms), "
+                << perf.getTotal().berlekampUpdates << " Berlekamp updates, "
+                << perf.getTotal().degBumps << " deg bumps";
+            MV_POLY_LOG_IF(MV_POLY_TRACE_SUMMARY, cachingSupports)
+                << "supports: " << perf.getTotal().newSupportUses << " new, "
+                << perf.getTotal().reusedSupportUses << " reused in convolutions, "
+                << perf.getTotal().shiftedSupports << " shifted, "
+                << perf.getTotal().rebuiltSupports << " rebuilt";
+        )
+        return getPolynomialList();
+
+    }
+
+    /**
+     * Feeds the next element of the sequence: stores \c value at
+     * nextPoint() in the sequence and makes one step of the algorithm, so
+     * the sequence can be extended as it becomes known (e.g. syndromes
+     * found by majority voting). Steps can be interleaved with
+     * computeMinimalSet which continues from the current point.
+     * @param value Sequence element at nextPoint().
+     */
+    void step(CoefT const & value) {
+        setSequenceElement(seq, curPoint, value);
+        if (cachingSupports || executor)
+            seqView.update(seq, curPoint, value);
+        infoUpdate(curPoint);
+        ++curPoint;
+        if (seqLen < curPoint)
+            seqLen = curPoint;
+    }
+
+    /// Minimal set of polynomials for the part of sequence processed so far.
+    PolynomialCollection current() const {
         return getPolynomialList();
+    }
+
+    /// Point of the sequence element the next step expects.
+    PointT const & nextPoint() const {
+        return curPoint;
+    }
+
+    /**
+     * Writes the state of the algorithm (F, G, delta-set, the current point
+     * and the sequence length) in binary form, so that the computation can
+     * be resumed by \c restoreCheckpoint, e.g. when the same sequence
+     * prefix is extended. The checkpoint refers to the processed prefix of
+     * the sequence by its fingerprint. The cost is linear in the size of
+     * the state and the prefix.
+     */
+    void saveCheckpoint(std::ostream & os) const {
+        writeUInt(os, CHECKPOINT_MAGIC, 4);
+        writeUInt(os, CHECKPOINT_VERSION, 2);
+        writeUInt(os, Dim, 2);
+        writeBinary(os, curPoint);
+        writeBinary(os, seqLen);
+        writeUInt(os, prefixFingerprint(curPoint));
+        writePointPolyMap(os, F);
+        writePointPolyMap(os, G);
+        writeUInt(os, oldDeltaPoints.size());
+        for (typename PointCollection::const_iterator it = oldDeltaPoints.begin();
+                it != oldDeltaPoints.end(); ++it)
+            writeBinary(os, *it);
+    }
 
+    /**
+     * Replaces the state of the algorithm with the one saved by
+     * \c saveCheckpoint; the next step (or \c computeMinimalSet) continues
+     * from the saved point. The sequence should start with the prefix
+     * the checkpoint was taken on, this is checked if \c checkPrefix is set.
+     * Throws std::runtime_error if the data is malformed or the prefix
+     * differs; the state is unchanged in that case.
+     */
+    void restoreCheckpoint(std::istream & is, bool checkPrefix = true) {
+        if (readUInt(is, 4) != CHECKPOINT_MAGIC)
+            throw std::runtime_error("not a BMSA checkpoint");
+        if (readUInt(is, 2) != CHECKPOINT_VERSION)
+            throw std::runtime_error("unsupported BMSA checkpoint version");
+        if (readUInt(is, 2) != (uint64_t)Dim)
+            throw std::runtime_error("BMSA checkpoint dimension mismatch");
+        PointT point, len;
+        readBinary(is, point);
+        readBinary(is, len);
+        uint64_t const prefix = readUInt(is);
+        if (checkPrefix && prefix != prefixFingerprint(point))
+            throw std::runtime_error("BMSA checkpoint is taken on other sequence");
+        PointPolyMap newF, newG;
+        readPointPolyMap(is, newF);
+        readPointPolyMap(is, newG);
+        PointCollection newDeltaPoints;
+        for (uint64_t n = readUInt(is); n > 0; --n) {
+            newDeltaPoints.push_back(PointT());
+            readBinary(is, newDeltaPoints.back());
+        }
+        curPoint = point;
+        seqLen = len;
+        F.swap(newF);
+        G.swap(newG);
+        oldDeltaPoints.swap(newDeltaPoints);
+        supports.clear();
+        if (cachingSupports || executor)
+            seqView.refresh(seq);
+    }
+
+    /**
+     * Switches caching of the supports of polynomials. In this mode the
+     * nonzero terms of every f in F are cached between the steps: when f
+     * goes to new F via deg bump its cached terms are just shifted, and only
+     * polynomials produced by Berlekamp formula are scanned anew, so the
+     * discrepancy of f costs O(|supp f|) instead of the walk over all points
+     * below deg f. Every discrepancy is still summed up in full: k moves
+     * at every step, so the sum of an unchanged f reads other elements of
+     * the sequence and nothing of the previous sums can be reused. The
+     * sequence must be changed only through \c step while the mode is on
+     * (a Polynomial or a map is copied into DenseSequence, DenseSequence is
+     * read directly).
+     */
+    void setSupportCaching(bool on) {
+        cachingSupports = on;
+        supports.clear();
+        if (cachingSupports || executor)
+            seqView.refresh(seq);
+    }
+
+    /**
+     * Sets the pool to compute discrepancies and polynomials of new F
+     * within a step in parallel (null for sequential computation). The
+     * results are merged in the same order as in sequential case, so they
+     * don't depend on the executor. The pool isn't owned by the algorithm.
+     */
+    void setExecutor(WorkStealingPool * executor_) {
+        executor = executor_;
+        if (cachingSupports || executor)
+            seqView.refresh(seq);
+    }
+
+    WorkStealingPool * getExecutor() const {
+        return executor;
+    }
+
+    bool isSupportCaching() const {
+        return cachingSupports;
+    }
+
+#if MV_POLY_PERF_COUNTERS
+    /**
+     * Counters summed over the steps made so far and of every step if
+     * recorded (cf. BmsaCounters); available only if MV_POLY_PERF_COUNTERS
+     * is 1.
+     */
+    BmsaPerfCounters<PointT> const & getPerfCounters() const {
+        return perf;
+    }
+
+    /// Keeps the counters of every step (cf. BmsaPerfCounters::setStepsRecorded).
+    void setCounterStepsRecorded(bool recorded) {
+        perf.setStepsRecorded(recorded);
+    }
+
+    /// Writes the counters as JSON (cf. BmsaPerfCounters::writeJson).
+    void writeCountersJson(std::ostream & os) const {
+        perf.writeJson(os);
+    }
+
+    void resetCounters() {
+        perf.clear();
+    }
+#endif
+
+    /**
+     * Sets the function called with the record of every step (cf.
+     * StepTrace); an empty function turns the tracing off. Unlike the
+     * logging (cf. Trace.hpp) it is chosen at run time, and while it isn't
+     * set a step only checks for it.
+     */
+    void setTraceSink(TraceSink const & sink) {
+        traceSink = sink;
     }
 
     PointPolyMap const & getF() const {
         return F;
     }
 
+    /**
+     * Auxiliary polynomials: g at the maximal point c of the delta-set has
+     * failed at the point k = deg g + c and is scaled so that its
+     * discrepancy there is 1.
+     */
+    PointPolyMap const & getG() const {
+        return G;
+    }
+
+    /**
+     * Moves F and G to \c f and \c g without copying them (cf. getF,
+     * getG); the algorithm gets the former contents of \c f and \c g and
+     * mustn't make steps any more.
+     */
+    void releaseFG(PointPolyMap & f, PointPolyMap & g) {
+        f.swap(F);
+        g.swap(G);
+    }
+
     PointCollection const & getDeltaPoints() const {
         return oldDeltaPoints;
     }
@@ -236,7 +801,37 @@ public:
     }
 
 private:
-    PolynomialCollection getPolynomialList() {
+    static const uint64_t CHECKPOINT_MAGIC = 0x41534d42; // "BMSA"
+
+    static const uint64_t CHECKPOINT_VERSION = 1;
+
+    /// Fingerprint of the sequence elements at the points below \c end.
+    uint64_t prefixFingerprint(PointT const & end) const {
+        std::ostringstream oss;
+        for (PointT pt; pt < end; ++pt)
+            writeBinary(oss, getSequenceElement(seq, pt));
+        return fingerprint(oss.str());
+    }
+
+    static void writePointPolyMap(std::ostream & os, PointPolyMap const & m) {
+        writeUInt(os, m.size());
+        for (typename PointPolyMap::const_iterator it = m.begin(); it != m.end(); ++it) {
+            writeBinary(os, it->first);
+            writeBinary(os, it->second);
+        }
+    }
+
+    static void readPointPolyMap(std::istream & is, PointPolyMap & m) {
+        for (uint64_t n = readUInt(is); n > 0; --n) {
+            PointT pt;
+            readBinary(is, pt);
+            PolynomialT p;
+            readBinary(is, p);
+            m.push_back(pt, std::move(p));
+        }
+    }
+
+    PolynomialCollection getPolynomialList() const {
         PolynomialCollection result;
 //        std::copy(
 //                make_choose_polynomial_iterator(F.begin()),
@@ -23,11 +23,15 @@
 #include <sstream>
 #include <string>
 #include <typeinfo>
+#include <vector>
 
 #include <cassert>
 
 #include <tr1/functional>
 
+#include <boost/iterator/iterator_facade.hpp>
+#include <boost/range/iterator_range.hpp>
+
 #include "Utilities.hpp"
 #include "Point.hpp"
 #include "CoefficientTraits.hpp"
@@ -41,6 +45,10 @@ namespace mv_poly {
 /// \cond
 template<typename T>
 class Polynomial;
+
+// defined in TextParser.hpp, included at the end
+template<typename T>
+void parsePolynomial(std::string const & s, Polynomial<T> & p);
 /// \endcond
 
 /** Neat template type for actually getting multivariate polynomials.
@@ -103,8 +111,9 @@ public:
 
     Polynomial() : data(1, CoefficientTraits<ElemT>::addId()) {}
 
+    /// Polynomial in the text format of operator<< (cf. parsePolynomial).
     explicit Polynomial(std::string const & s) {
-        loadPolyFromString(*this, s );
+        parsePolynomial(s, *this);
     }
 
     /**
@@ -247,18 +256,48 @@ public:
 
     void setCoefs(StorageT const & data)  { this->data = data; }
 
+    /// Takes \c data (non-empty) without copying, \c data gets the old ones.
+    void swapCoefs(StorageT & data)  { this->data.swap(data); }
+
+    /// Exchanges the coefficients with \c other without copying.
+    void swap(Polynomial & other)  { data.swap(other.data); }
+
+    /**
+     * Polynomial 0, built once per type.
+     */
+    static Polynomial const & zero() {
+        static Polynomial const result;
+        return result;
+    }
+
+    /**
+     * Polynomial 1, built once per type (its coefficients don't depend on
+     * the modulus of NTL fields).
+     */
+    static Polynomial const & identity() {
+        static Polynomial const result = monomial(Point<VAR_CNT>());
+        return result;
+    }
+
     /**
      * Returns polynomial 1.
      * @return polynomial 1
      */
     static Polynomial getId() {
-        std::string strRep;
-        std::fill_n(std::back_inserter(strRep), VAR_CNT, '[');
-        std::ostringstream elemId;
-        elemId << CoefficientTraits<CoefT>::multId();
-        strRep += elemId.str();
-        std::fill_n(std::back_inserter(strRep), VAR_CNT, ']');
-        return Polynomial(strRep);
+        return identity();
+    }
+
+    /**
+     * Monomial <tt>c x^m</tt>, the storage is written directly.
+     * @param m Degree (Point<VAR_CNT> or any type with VAR_CNT coordinates
+     * subscripted by <tt>[]</tt>).
+     */
+    template<typename Pt>
+    static Polynomial monomial(Pt const & m,
+            CoefT const & c = CoefficientTraits<CoefT>::multId()) {
+        Polynomial result;
+        setCoefficient(result, m, c);
+        return result;
     }
 
 private:
@@ -295,6 +334,21 @@ private:
     friend
     void applyMonomialMultiplication(S & elem, Pt const & monomial);
 
+    template<int Dim>
+    friend
+    struct GenericPolyKernels;
+
+    template<int Dim>
+    friend
+    struct PolyKernels;
+
+    template<int VarCnt>
+    friend
+    struct CoefficientAssigner;
+
+    template<int VarCnt>
+    friend
+    struct ShiftedMultipleSubtractor;
 
     /**
      * Delete trailing zeros in coefficient collection \c data.
@@ -304,15 +358,10 @@ private:
         if (data.size() < 2)
             return; // we will not delete single zero
         ElemT tempDefElem = ElemT();
-        typename StorageT::iterator it = --data.end(); // it is still valid
-        do {
-            if (*it == tempDefElem)
-                --it;
-            else
-                break;
-        } while (it != data.begin());
-        if (it == data.begin()) // we'll not delete all the elements
-            ++it;
+        typename StorageT::iterator it = data.end(); // past the last nonzero
+        while (--it != data.begin() && *it == tempDefElem)
+            ;
+        ++it; // we'll not delete all the elements
         data.erase(it, data.end());
     }
 
@@ -383,15 +432,155 @@ T applySubscript(S const & el, ConstSlice<Body, Dim, Dim> const & pt) {
         return el;
 }
 
+/**
+ * Kernels for subscript, monomial multiplication and evaluation of
+ * polynomials with \c Dim variables at the top level of the recursion.
+ * This general version goes down the <tt>Polynomial<… Polynomial<T>… ></tt>
+ * nest with the help of ConstSlice (cf. applySubscript,
+ * applyMonomialMultiplication); see PolyKernels for the dimensions we
+ * actually deploy.
+ */
+template<int Dim>
+struct GenericPolyKernels {
+    template<typename T, typename Pt>
+    static typename Polynomial<T>::CoefT
+    subscript(Polynomial<T> const & p, Pt const & pt) {
+        typedef typename Polynomial<T>::CoefT CoefT;
+        if (pt[0] < (int)0 || (int)p.data.size() <= pt[0])
+            return CoefficientTraits<CoefT>::addId();
+        else
+            return applySubscript<CoefT>(p.data[pt[0]], make_slice<Dim>(pt));
+    }
+
+    template<typename T, typename Pt>
+    static void shift(Polynomial<T> & p, Pt const & monomial) {
+        typedef typename Polynomial<T>::StorageT StorageT;
+        for (typename StorageT::iterator it = p.data.begin(); it != p.data.end(); ++it)
+            applyMonomialMultiplication(*it, make_slice<Dim>(monomial));
+        std::fill_n(std::front_inserter(p.data), monomial[0], T());
+    }
+
+    template<typename T, typename CurvePoint>
+    static typename Polynomial<T>::CoefT
+    eval(Polynomial<T> const & p, CurvePoint const & cp) {
+        typedef typename Polynomial<T>::CoefT CoefT;
+        auto f = [&cp](CoefT const & val, T const & a) {
+            return val*cp[0] + a(make_slice<Dim>(cp));
+        };
+        return std::accumulate(p.data.rbegin(), p.data.rend(),
+                CoefficientTraits<CoefT>::addId(), f);
+    }
+};
+
+/**
+ * Polynomial kernels dispatched on the number of variables. For 2 and 3
+ * variables (Hermitian codes and Sakata's examples) these are specialized
+ * with straight-line loops over the coefficient storage; other cases use
+ * GenericPolyKernels.
+ */
+template<int Dim>
+struct PolyKernels : GenericPolyKernels<Dim> {};
+
+/// \cond
+template<>
+struct PolyKernels<2> {
+    template<typename T, typename Pt>
+    static typename Polynomial<T>::CoefT
+    subscript(Polynomial<T> const & p, Pt const & pt) {
+        typedef typename Polynomial<T>::CoefT CoefT;
+        if (pt[0] < 0 || (long)p.data.size() <= pt[0])
+            return CoefficientTraits<CoefT>::addId();
+        typename T::StorageT const & row = p.data[pt[0]].data;
+        if (pt[1] < 0 || (long)row.size() <= pt[1])
+            return CoefficientTraits<CoefT>::addId();
+        return row[pt[1]];
+    }
+
+    template<typename T, typename Pt>
+    static void shift(Polynomial<T> & p, Pt const & monomial) {
+        typedef typename Polynomial<T>::StorageT StorageT;
+        typedef typename T::ElemT CoefT;
+        for (typename StorageT::iterator it = p.data.begin(); it != p.data.end(); ++it)
+            it->data.insert(it->data.begin(), monomial[1], CoefT());
+        p.data.insert(p.data.begin(), monomial[0], T());
+    }
+
+    template<typename T, typename CurvePoint>
+    static typename Polynomial<T>::CoefT
+    eval(Polynomial<T> const & p, CurvePoint const & cp) {
+        typedef typename Polynomial<T>::CoefT CoefT;
+        typedef typename Polynomial<T>::StorageT::const_reverse_iterator RowIt;
+        typedef typename T::StorageT::const_reverse_iterator CoefIt;
+        CoefT res = CoefficientTraits<CoefT>::addId();
+        for (RowIt it = p.data.rbegin(); it != p.data.rend(); ++it) {
+            CoefT row = CoefficientTraits<CoefT>::addId();
+            for (CoefIt jt = it->data.rbegin(); jt != it->data.rend(); ++jt)
+                row = row*cp[1] + *jt;
+            res = res*cp[0] + row;
+        }
+        return res;
+    }
+};
+
+template<>
+struct PolyKernels<3> {
+    template<typename T, typename Pt>
+    static typename Polynomial<T>::CoefT
+    subscript(Polynomial<T> const & p, Pt const & pt) {
+        typedef typename Polynomial<T>::CoefT CoefT;
+        if (pt[0] < 0 || (long)p.data.size() <= pt[0])
+            return CoefficientTraits<CoefT>::addId();
+        typename T::StorageT const & plane = p.data[pt[0]].data;
+        if (pt[1] < 0 || (long)plane.size() <= pt[1])
+            return CoefficientTraits<CoefT>::addId();
+        typename T::ElemT::StorageT const & row = plane[pt[1]].data;
+        if (pt[2] < 0 || (long)row.size() <= pt[2])
+            return CoefficientTraits<CoefT>::addId();
+        return row[pt[2]];
+    }
+
+    template<typename T, typename Pt>
+    static void shift(Polynomial<T> & p, Pt const & monomial) {
+        typedef typename Polynomial<T>::StorageT StorageT;
+        typedef typename T::ElemT RowT;
+        typedef typename RowT::ElemT CoefT;
+        for (typename StorageT::iterator it = p.data.begin(); it != p.data.end(); ++it) {
+            for (typename T::StorageT::iterator jt = it->data.begin();
+                    jt != it->data.end(); ++jt)
+                jt->data.insert(jt->data.begin(), monomial[2], CoefT());
+            it->data.insert(it->data.begin(), monomial[1], RowT());
+        }
+        p.data.insert(p.data.begin(), monomial[0], T());
+    }
+
+    template<typename T, typename CurvePoint>
+    static typename Polynomial<T>::CoefT
+    eval(Polynomial<T> const & p, CurvePoint const & cp) {
+        typedef typename Polynomial<T>::CoefT CoefT;
+        typedef typename Polynomial<T>::StorageT::const_reverse_iterator PlaneIt;
+        typedef typename T::StorageT::const_reverse_iterator RowIt;
+        typedef typename T::ElemT::StorageT::const_reverse_iterator CoefIt;
+        CoefT res = CoefficientTraits<CoefT>::addId();
+        for (PlaneIt it = p.data.rbegin(); it != p.data.rend(); ++it) {
+            CoefT plane = CoefficientTraits<CoefT>::addId();
+            for (RowIt jt = it->data.rbegin(); jt != it->data.rend(); ++jt) {
+                CoefT row = CoefficientTraits<CoefT>::addId();
+                for (CoefIt kt = jt->data.rbegin(); kt != jt->data.rend(); ++kt)
+                    row = row*cp[2] + *kt;
+                plane = plane*cp[1] + row;
+            }
+            res = res*cp[0] + plane;
+        }
+        return res;
+    }
+};
+/// \endcond
+
 template<typename T>
 template<template <typename PointImpl> class OrderPolicy>
 typename Polynomial<T>::CoefT
 Polynomial<T>::operator[](Point<VAR_CNT, OrderPolicy> const & pt) const {
-    if (pt[0] < (int)0 || (int)data.size() <= pt[0])
-        return CoefficientTraits<CoefT>::addId();
-    else
-        return applySubscript<Polynomial<T>::CoefT>(
-                data[pt[0]], make_slice<VAR_CNT>(pt));
+    return PolyKernels<VAR_CNT>::subscript(*this, pt);
 }
 
 template<typename T>
@@ -434,12 +623,10 @@ conv(
         PointT const & degf,
         PointT const & m) {
     assert( byCoordinateLess(degf, m) );
-    ResT res;
-    PointT i;
-    while(i <= degf) {
-        res += f[i] * u[i + m - degf];
-        ++i;
-    }
+    ResT res = CoefficientTraits<ResT>::addId();
+    PointT const shift = m - degf;
+    for (PointT i; i <= degf; ++i)
+        res += f[i] * u[i + shift];
     return res;
 }
 
@@ -491,14 +678,14 @@ std::istream& operator>>(std::istream& is, Polynomial<T> & p) {
 }
 
 /**
- * Loading polynomial from the string.
+ * Loading polynomial from the string (cf. parsePolynomial).
  * @param[out] p Polynomial instance to get in loaded data.
  * @param[in] s String that defines contents of polynomial to de loaded.
+ * @throw ParseError If \c s doesn't hold one polynomial.
  */
 template<typename T>
 void loadPolyFromString( Polynomial<T> & p, std::string const & s ) {
-    std::istringstream is(s);
-    is >> p;
+    parsePolynomial(s, p);
 }
 
 /**
@@ -592,9 +779,7 @@ template<typename T>
 template<template <typename PointImpl> class OrderPolicy>
 inline
 Polynomial<T> Polynomial<T>::operator<<=(Point<VAR_CNT, OrderPolicy> const & monomial) {
-    for (typename StorageT::iterator it = data.begin(); it != data.end(); ++it)
-        applyMonomialMultiplication(*it, make_slice<VAR_CNT>(monomial));
-    std::fill_n(std::front_inserter(data), monomial[0], ElemT());
+    PolyKernels<VAR_CNT>::shift(*this, monomial);
     return *this;
 }
 
@@ -719,60 +904,640 @@ Polynomial<T> operator-(Polynomial<T> lhs, Polynomial<T> const & rhs) {
     return lhs -= rhs;
 }
 
-template<typename Pt, typename T, typename ResultT>
-ResultT
-polyToDegCoefMapImpl(
-        Polynomial<T> const & poly,
-        Pt deg,
-        ResultT & result) {
-    BOOST_FOREACH(typename Polynomial<T>::CoefT const & cf, poly.getCoefs()) {
-        result[deg] = cf;
-        ++deg[0];
+/// \cond
+/*
+ * Implementation of forEachCoefficient: walks the storage of polynomial with
+ * VarCnt variables filling coordinates of pt starting from the given level.
+ */
+template<int VarCnt>
+struct CoefficientWalker {
+    template<typename PolyT, typename Pt, typename F>
+    static void walk(PolyT const & p, Pt & pt, int level, F & f) {
+        typename PolyT::StorageT const & coefs = p.getCoefs();
+        for (size_t i = 0; i < coefs.size(); ++i) {
+            pt[level] = i;
+            CoefficientWalker<VarCnt - 1>::walk(coefs[i], pt, level + 1, f);
+        }
+        pt[level] = 0;
     }
-    deg[0] = 0;
-    return result;
+};
+
+template<>
+struct CoefficientWalker<1> {
+    template<typename PolyT, typename Pt, typename F>
+    static void walk(PolyT const & p, Pt & pt, int level, F & f) {
+        typename PolyT::StorageT const & coefs = p.getCoefs();
+        for (size_t i = 0; i < coefs.size(); ++i) {
+            pt[level] = i;
+            f(static_cast<Pt const &>(pt), coefs[i]);
+        }
+        pt[level] = 0;
+    }
+};
+/// \endcond
+
+/**
+ * Calls <tt>f(pt, c)</tt> for every stored coefficient \c c of \c p
+ * (zeros included) in storage order, \c pt being the degree of the
+ * corresponding monomial.
+ * @param p Polynomial to traverse.
+ * @param f Functor taking <tt>(Pt const &, CoefT const &)</tt>.
+ */
+template<typename Pt, typename T, typename F>
+void forEachCoefficient(Polynomial<T> const & p, F f) {
+    Pt pt;
+    CoefficientWalker<Polynomial<T>::VAR_CNT>::walk(p, pt, 0, f);
 }
 
-template<typename Pt, typename T, typename ResultT>
-ResultT
-polyToDegCoefMapImpl(
-        Polynomial< Polynomial <T> > const & poly,
-        Pt deg,
-        ResultT & result) {
-    BOOST_FOREACH(typename Polynomial< Polynomial <T> >::ElemT const & cf, poly.getCoefs()) {
-        polyToDegCoefMapImpl(cf, make_slice(deg), result);
-        ++deg[0];
+/// \cond
+/*
+ * Implementation of setCoefficient: grows the storage of polynomial with
+ * VarCnt variables to hold the coordinates of pt starting from the given
+ * level.
+ */
+template<int VarCnt>
+struct CoefficientAssigner {
+    template<typename PolyT, typename Pt, typename C>
+    static void assign(PolyT & p, Pt const & pt, int level, C const & c) {
+        if ((long)p.data.size() <= pt[level])
+            p.data.resize(pt[level] + 1);
+        CoefficientAssigner<VarCnt - 1>::assign(p.data[pt[level]], pt, level + 1, c);
     }
-    deg[0] = 0;
-    return result;
+};
+
+template<>
+struct CoefficientAssigner<1> {
+    template<typename PolyT, typename Pt, typename C>
+    static void assign(PolyT & p, Pt const & pt, int level, C const & c) {
+        if ((long)p.data.size() <= pt[level])
+            p.data.resize(pt[level] + 1, CoefficientTraits<C>::addId());
+        p.data[pt[level]] = c;
+    }
+};
+/// \endcond
+
+/**
+ * Sets the coefficient of \c p at the monomial of degree \c pt, the
+ * polynomial storage grows if needed.
+ */
+template<typename Pt, typename T>
+void setCoefficient(
+        Polynomial<T> & p,
+        Pt const & pt,
+        typename Polynomial<T>::CoefT const & c) {
+    CoefficientAssigner<Polynomial<T>::VAR_CNT>::assign(p, pt, 0, c);
+}
+
+/// \cond
+/*
+ * Implementation of subtractShiftedMultiple: subtracts c x^m q from
+ * polynomial with VarCnt variables, m read starting from the given level.
+ */
+template<int VarCnt>
+struct ShiftedMultipleSubtractor {
+    template<typename PolyT, typename Pt, typename C>
+    static void apply(PolyT & p, C const & c, PolyT const & q, Pt const & m, int level) {
+        size_t const offset = m[level];
+        if (p.data.size() < offset + q.data.size())
+            p.data.resize(offset + q.data.size());
+        for (size_t i = 0; i < q.data.size(); ++i)
+            ShiftedMultipleSubtractor<VarCnt - 1>::apply(
+                    p.data[offset + i], c, q.data[i], m, level + 1);
+    }
+};
+
+template<>
+struct ShiftedMultipleSubtractor<1> {
+    template<typename PolyT, typename Pt, typename C>
+    static void apply(PolyT & p, C const & c, PolyT const & q, Pt const & m, int level) {
+        C const zero = CoefficientTraits<C>::addId();
+        size_t const offset = m[level];
+        if (p.data.size() < offset + q.data.size())
+            p.data.resize(offset + q.data.size(), zero);
+        for (size_t i = 0; i < q.data.size(); ++i)
+            if (q.data[i] != zero)
+                p.data[offset + i] -= c * q.data[i];
+    }
+};
+/// \endcond
+
+/**
+ * Subtracts <tt>c x^m q</tt> from \c p in place: unlike
+ * <tt>p -= c * q << m</tt>, no temporary polynomial is made and the
+ * storage of \c p is only grown.
+ */
+template<typename Pt, typename T>
+void subtractShiftedMultiple(
+        Polynomial<T> & p,
+        typename Polynomial<T>::CoefT const & c,
+        Polynomial<T> const & q,
+        Pt const & m) {
+    ShiftedMultipleSubtractor<Polynomial<T>::VAR_CNT>::apply(p, c, q, m, 0);
 }
 
+/**
+ * \class PolyTerm
+ * Nonzero term of a polynomial yielded by nonzeroTerms and orderedTerms:
+ * the degree of its monomial and the coefficient, which stays in the
+ * polynomial storage.
+ */
+template<typename Pt, typename CoefT>
+class PolyTerm {
+public:
+    PolyTerm() : coef(0) {}
+
+    PolyTerm(Pt const & pt_, CoefT const * coef_) : pt(pt_), coef(coef_) {}
+
+    Pt const & getPoint() const {
+        return pt;
+    }
+
+    CoefT const & getCoef() const {
+        return *coef;
+    }
+
+private:
+    Pt pt;
+
+    CoefT const * coef;
+};
+
+/// \cond
+/*
+ * Cursor over the nonzero coefficients of polynomial with VarCnt variables
+ * in storage order: a position per level, the positions of the levels
+ * below are kept by the nested cursor.
+ */
+template<typename PolyT, int VarCnt = PolyT::VAR_CNT>
+struct TermCursor {
+    typedef typename PolyT::CoefT CoefT;
+
+    /// Moves to the first nonzero term of p, false if there is none.
+    bool first(PolyT const & p) {
+        coefs = &p.getCoefs();
+        for (i = 0; i < coefs->size(); ++i)
+            if (inner.first((*coefs)[i]))
+                return true;
+        return false;
+    }
+
+    /// Moves to the next nonzero term, false if there is none.
+    bool next() {
+        if (inner.next())
+            return true;
+        for (++i; i < coefs->size(); ++i)
+            if (inner.first((*coefs)[i]))
+                return true;
+        return false;
+    }
+
+    template<typename Pt>
+    void point(Pt & pt, int level) const {
+        pt[level] = i;
+        inner.point(pt, level + 1);
+    }
+
+    CoefT const & coef() const {
+        return inner.coef();
+    }
+
+    typename PolyT::StorageT const * coefs;
+
+    size_t i;
+
+    TermCursor<typename PolyT::ElemT> inner;
+};
+
+template<typename PolyT>
+struct TermCursor<PolyT, 1> {
+    typedef typename PolyT::CoefT CoefT;
+
+    bool first(PolyT const & p) {
+        coefs = &p.getCoefs();
+        i = 0;
+        return skipZeros();
+    }
+
+    bool next() {
+        ++i;
+        return skipZeros();
+    }
+
+    bool skipZeros() {
+        CoefT const zero = CoefficientTraits<CoefT>::addId();
+        while (i < coefs->size() && (*coefs)[i] == zero)
+            ++i;
+        return i < coefs->size();
+    }
+
+    template<typename Pt>
+    void point(Pt & pt, int level) const {
+        pt[level] = i;
+    }
+
+    CoefT const & coef() const {
+        return (*coefs)[i];
+    }
+
+    typename PolyT::StorageT const * coefs;
+
+    size_t i;
+};
+
+/*
+ * Calls f(row, pt, level) for every polynomial in the last variable (a
+ * "row") of polynomial with VarCnt variables, pt holding the degrees in
+ * the other variables.
+ */
+template<int VarCnt>
+struct RowWalker {
+    template<typename PolyT, typename Pt, typename F>
+    static void walk(PolyT const & p, Pt & pt, int level, F & f) {
+        typename PolyT::StorageT const & coefs = p.getCoefs();
+        for (size_t i = 0; i < coefs.size(); ++i) {
+            pt[level] = i;
+            RowWalker<VarCnt - 1>::walk(coefs[i], pt, level + 1, f);
+        }
+        pt[level] = 0;
+    }
+};
+
+template<>
+struct RowWalker<1> {
+    template<typename PolyT, typename Pt, typename F>
+    static void walk(PolyT const & p, Pt & pt, int level, F & f) {
+        f(p, pt, level);
+    }
+};
+/// \endcond
+
+/**
+ * \class NonzeroTermIterator
+ * Forward iterator over the nonzero terms (cf. PolyTerm) of a polynomial
+ * in storage order, the same as forEachCoefficient's but without zeros.
+ * It holds a position per variable and doesn't allocate.
+ */
+template<typename PolyT, typename Pt>
+class NonzeroTermIterator : public boost::iterator_facade<
+        NonzeroTermIterator<PolyT, Pt>,
+        PolyTerm<Pt, typename PolyT::CoefT> const,
+        boost::forward_traversal_tag> {
+public:
+    /// The end.
+    NonzeroTermIterator() : atEnd(true) {}
+
+    explicit NonzeroTermIterator(PolyT const & p) : atEnd(!cursor.first(p)) {
+        update();
+    }
+
+private:
+    friend class boost::iterator_core_access;
+
+    typedef PolyTerm<Pt, typename PolyT::CoefT> Term;
+
+    void update() {
+        if (atEnd)
+            return;
+        Pt pt;
+        cursor.point(pt, 0);
+        term = Term(pt, &cursor.coef());
+    }
+
+    void increment() {
+        atEnd = !cursor.next();
+        update();
+    }
+
+    bool equal(NonzeroTermIterator const & other) const {
+        return atEnd == other.atEnd
+                && (atEnd || &term.getCoef() == &other.term.getCoef());
+    }
+
+    Term const & dereference() const {
+        return term;
+    }
+
+    TermCursor<PolyT> cursor;
+
+    bool atEnd;
+
+    Term term;
+};
+
+template<typename PolyT, typename Pt>
+class OrderedTermRange;
+
+/**
+ * \class OrderedTermIterator
+ * Single-pass iterator over the nonzero terms (cf. PolyTerm) of a
+ * polynomial in the order of the point type \c Pt (<tt>Pt::operator<</tt>);
+ * the merge itself is kept by its OrderedTermRange.
+ */
+template<typename PolyT, typename Pt>
+class OrderedTermIterator : public boost::iterator_facade<
+        OrderedTermIterator<PolyT, Pt>,
+        PolyTerm<Pt, typename PolyT::CoefT> const,
+        boost::single_pass_traversal_tag> {
+public:
+    /// The end.
+    OrderedTermIterator() : range(0) {}
+
+    explicit OrderedTermIterator(OrderedTermRange<PolyT, Pt> const & r) :
+        range(&r) {}
+
+private:
+    friend class boost::iterator_core_access;
+
+    typedef PolyTerm<Pt, typename PolyT::CoefT> Term;
+
+    bool atEnd() const {
+        return range == 0 || range->done;
+    }
+
+    void increment() {
+        range->take();
+    }
+
+    bool equal(OrderedTermIterator const & other) const {
+        return atEnd() == other.atEnd();
+    }
+
+    Term const & dereference() const {
+        return range->term;
+    }
+
+    OrderedTermRange<PolyT, Pt> const * range;
+};
+
+/**
+ * \class OrderedTermRange
+ * Nonzero terms of a polynomial in the order of the point type \c Pt,
+ * computed lazily by a k-way merge of the rows of the polynomial (the
+ * polynomials in the last variable), each of them being sorted by any
+ * monomial order.
+ *
+ * The range keeps a head index per row and a binary heap of the rows by
+ * their head terms. Unlike NonzeroTermIterator it allocates: two vectors
+ * of O(k) for k rows, once when the range is made; the merge itself
+ * allocates nothing and a step takes O(log k) (plus the zeros skipped).
+ * The range is single pass: begin() restarts the merge and invalidates
+ * the former iterators.
+ */
+template<typename PolyT, typename Pt>
+class OrderedTermRange {
+public:
+    typedef OrderedTermIterator<PolyT, Pt> iterator;
+
+    typedef iterator const_iterator;
+
+    explicit OrderedTermRange(PolyT const & p) : done(true) {
+        auto collect = [this](RowT const & row, Pt const & pt, int level) {
+            if (!row.getCoefs().empty()) {
+                Row const r = { &row.getCoefs(), 0, level, pt };
+                rows.push_back(r);
+            }
+        };
+        Pt pt;
+        RowWalker<PolyT::VAR_CNT>::walk(p, pt, 0, collect);
+        heap.reserve(rows.size());
+    }
+
+    iterator begin() const {
+        heap.clear();
+        for (size_t r = 0; r < rows.size(); ++r) {
+            rows[r].i = 0;
+            if (skipZeros(rows[r]))
+                heap.push_back(r);
+        }
+        std::make_heap(heap.begin(), heap.end(), HeadGreater(rows));
+        take();
+        return iterator(*this);
+    }
+
+    iterator end() const {
+        return iterator();
+    }
+
+private:
+    friend class OrderedTermIterator<PolyT, Pt>;
+
+    typedef typename PolyT::CoefT CoefT;
+
+    typedef Polynomial<CoefT> RowT;
+
+    struct Row {
+        typename RowT::StorageT const * coefs;
+
+        /// Index of the head term.
+        size_t i;
+
+        /// Index of the last variable in \c head.
+        int level;
+
+        /// Degree of the head term.
+        Pt head;
+    };
+
+    /// Orders the heap by the least head on top.
+    struct HeadGreater {
+        explicit HeadGreater(std::vector<Row> const & rows_) : rows(rows_) {}
+
+        bool operator()(size_t a, size_t b) const {
+            return rows[b].head < rows[a].head;
+        }
+
+        std::vector<Row> const & rows;
+    };
+
+    /// Moves the head of \c row to a nonzero term, false if there is none.
+    static bool skipZeros(Row & row) {
+        CoefT const zero = CoefficientTraits<CoefT>::addId();
+        while (row.i < row.coefs->size() && (*row.coefs)[row.i] == zero)
+            ++row.i;
+        row.head[row.level] = row.i;
+        return row.i < row.coefs->size();
+    }
+
+    /// Makes the least head the current term and moves its row on.
+    void take() const {
+        done = heap.empty();
+        if (done)
+            return;
+        HeadGreater const greater(rows);
+        std::pop_heap(heap.begin(), heap.end(), greater);
+        Row & row = rows[heap.back()];
+        term = Term(row.head, &(*row.coefs)[row.i]);
+        ++row.i;
+        if (skipZeros(row))
+            std::push_heap(heap.begin(), heap.end(), greater);
+        else
+            heap.pop_back();
+    }
+
+    typedef PolyTerm<Pt, CoefT> Term;
+
+    mutable std::vector<Row> rows;
+
+    mutable std::vector<size_t> heap;
+
+    mutable Term term;
+
+    mutable bool done;
+};
+
+/**
+ * Nonzero terms of \c p in storage order, computed lazily (cf.
+ * NonzeroTermIterator). The polynomial must not change while the range is
+ * used.
+ */
+template<typename T>
+boost::iterator_range<
+    NonzeroTermIterator< Polynomial<T>, Point<Polynomial<T>::VAR_CNT> > >
+nonzeroTerms(Polynomial<T> const & p) {
+    typedef NonzeroTermIterator< Polynomial<T>, Point<Polynomial<T>::VAR_CNT> > It;
+    return boost::make_iterator_range(It(p), It());
+}
+
+/**
+ * Nonzero terms of \c p in the monomial order \c OrderPolicy, computed
+ * lazily (cf. OrderedTermRange, which allocates O(k) for the k rows of
+ * \c p once). The polynomial must not change while the range is used.
+ */
+template<template <typename> class OrderPolicy, typename T>
+OrderedTermRange< Polynomial<T>, Point<Polynomial<T>::VAR_CNT, OrderPolicy> >
+orderedTerms(Polynomial<T> const & p) {
+    return OrderedTermRange<
+            Polynomial<T>, Point<Polynomial<T>::VAR_CNT, OrderPolicy> >(p);
+}
+
+/**
+ * Map of the degrees of the nonzero terms of \c poly to their
+ * coefficients; for lookups only, to visit the terms use orderedTerms.
+ */
 template<template <typename> class OrderPolicy, typename T>
 std::map<
         Point<Polynomial<T>::VAR_CNT, OrderPolicy>,
         typename Polynomial<T>::CoefT>
 polyToDegCoefMap(Polynomial<T> const & poly) {
     typedef Point<Polynomial<T>::VAR_CNT, OrderPolicy> Pt;
-    Pt deg;
     std::map<Pt, typename Polynomial<T>::CoefT> result;
-    return polyToDegCoefMapImpl(poly, deg, result);
+    for (auto const & term : orderedTerms<OrderPolicy>(poly))
+        result.insert(result.end(),
+                std::make_pair(term.getPoint(), term.getCoef()));
+    return result;
 }
 
+/**
+ * Two-variable polynomial from the rows \c coefs[i] of length \c coefsLens[i]
+ * (the coefficients of <tt>x^i</tt>).
+ */
 template<typename PolyT>
 PolyT load_coefs(typename PolyT::CoefT const * coefs[], size_t len, size_t * coefsLens) {
-    typename PolyT::StorageT stor;
     typedef typename PolyT::ElemT ElemT;
-    for (size_t i = 0; i < len; ++i) {
-        ElemT elem;
-        elem.setCoefs(typename ElemT::StorageT(
-                coefs[i], coefs[i] + coefsLens[i]));
-        stor.push_back(elem);
-    }
+    typename PolyT::StorageT stor(len);
+    for (size_t i = 0; i < len; ++i)
+        if (coefsLens[i] > 0) {
+            typename ElemT::StorageT row(coefs[i], coefs[i] + coefsLens[i]);
+            stor[i].swapCoefs(row);
+        }
     PolyT res;
-    res.setCoefs(stor);
+    if (len > 0)
+        res.swapCoefs(stor);
     return res;
 }
 
+/// \cond
+/*
+ * Implementation of from_dense: builds the storage of polynomial with
+ * VarCnt variables from the box starting at the given level.
+ */
+template<int VarCnt>
+struct DenseBuilder {
+    template<typename PolyT, typename C, typename Extents>
+    static void build(PolyT & p, C const * coefs, Extents const & extents,
+            int level, long stride) {
+        if (extents[level] == 0)
+            return;
+        stride /= extents[level];
+        typename PolyT::StorageT stor(extents[level]);
+        for (long i = 0; i < extents[level]; ++i)
+            DenseBuilder<VarCnt - 1>::build(stor[i], coefs + i * stride,
+                    extents, level + 1, stride);
+        p.swapCoefs(stor);
+    }
+};
+
+template<>
+struct DenseBuilder<1> {
+    template<typename PolyT, typename C, typename Extents>
+    static void build(PolyT & p, C const * coefs, Extents const & extents,
+            int level, long) {
+        if (extents[level] == 0)
+            return;
+        typename PolyT::StorageT stor(coefs, coefs + extents[level]);
+        p.swapCoefs(stor);
+    }
+};
+
+template<typename Pt, typename C>
+Pt const & termPoint(std::pair<Pt, C> const & term) {
+    return term.first;
+}
+
+template<typename Pt, typename C>
+C const & termCoef(std::pair<Pt, C> const & term) {
+    return term.second;
+}
+
+template<typename Pt, typename C>
+Pt const & termPoint(PolyTerm<Pt, C> const & term) {
+    return term.getPoint();
+}
+
+template<typename Pt, typename C>
+C const & termCoef(PolyTerm<Pt, C> const & term) {
+    return term.getCoef();
+}
+/// \endcond
+
+/**
+ * Polynomial with the coefficients of the box with \c extents (cf.
+ * BoxLayout) stored by \c coefs in row-major order: the coefficient of
+ * <tt>x^m</tt> is <tt>coefs[m[0] * extents[1] * ... + m[1] * extents[2] *
+ * ... + m[VAR_CNT - 1]]</tt>. The storage is built directly, a row at a
+ * time.
+ */
+template<typename PolyT, typename Extents>
+PolyT from_dense(typename PolyT::CoefT const * coefs, Extents const & extents) {
+    long size = 1;
+    for (int i = 0; i < PolyT::VAR_CNT; ++i)
+        size *= extents[i];
+    PolyT result;
+    if (size > 0)
+        DenseBuilder<PolyT::VAR_CNT>::build(result, coefs, extents, 0, size);
+    return result;
+}
+
+/// from_dense for a contiguous container (e.g. std::vector) of the coefficients.
+template<typename PolyT, typename Container, typename Extents>
+PolyT from_dense(Container const & coefs, Extents const & extents) {
+    return from_dense<PolyT>(coefs.empty() ? 0 : &coefs[0], extents);
+}
+
+/**
+ * Sum of the terms of \c terms: a range of PolyTerm (e.g. nonzeroTerms of
+ * other polynomial) or of pairs of a degree and a coefficient (e.g. the
+ * map of polyToDegCoefMap). The degrees are supposed to be distinct, the
+ * coefficients are written to the storage directly.
+ */
+template<typename PolyT, typename Range>
+PolyT from_terms(Range const & terms) {
+    PolyT result;
+    for (auto const & term : terms)
+        setCoefficient(result, termPoint(term), termCoef(term));
+    return result;
+}
+
 template<typename T>
 typename Polynomial<T>::CoefT
 inline
@@ -789,11 +1554,7 @@ template<typename CurvePoint>
 inline
 typename Polynomial<T>::CoefT
 Polynomial<T>::operator()(CurvePoint const & cp) const {
-    auto f = [&cp](CoefT const & val, T const & a) {
-        return val*cp[0] + a(make_slice<Polynomial::VAR_CNT>(cp));
-    };
-    return std::accumulate(data.rbegin(), data.rend(),
-            CoefficientTraits<CoefT>::addId(), f);
+    return PolyKernels<VAR_CNT>::eval(*this, cp);
 }
 
 template<typename T>
@@ -806,4 +1567,6 @@ Polynomial<T>::operator()(ConstSlice<Body, Dim, Dim - 1> const & sl) const {
 
 } // namespace mv_poly
 
+#include "TextParser.hpp"
+
 #endif /* MV_POLY_HPP_ */